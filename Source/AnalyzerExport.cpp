@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    AnalyzerExport.cpp
+
+  ==============================================================================
+*/
+
+#include "AnalyzerExport.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+ #include <time.h>
+ #define AUDIOPLUGINBETA_POSIX_SHM 1
+#else
+ #define AUDIOPLUGINBETA_POSIX_SHM 0
+#endif
+
+namespace
+{
+    // đáy của phổ trong segment (dB)
+    constexpr float exportMinDecibels = -120.f;
+
+    // mỗi instance một tên riêng trong cùng process
+    std::atomic<int> nextInstance{ 0 };
+
+    void writeDecibels(float* destination, const std::vector<float>& magnitudes, std::uint32_t numPoints)
+    {
+        for (std::uint32_t i = 0; i < numPoints; ++i)
+            destination[i] = i < magnitudes.size()
+                ? juce::Decibels::gainToDecibels(magnitudes[i], exportMinDecibels)
+                : exportMinDecibels;
+    }
+}
+
+AnalyzerExport::AnalyzerExport()
+{
+   #if AUDIOPLUGINBETA_POSIX_SHM
+    name << AnalyzerExportLayout::namePrefix << (int)getpid() << "." << nextInstance++;
+   #endif
+}
+
+AnalyzerExport::~AnalyzerExport()
+{
+    close();
+}
+
+bool AnalyzerExport::isSupported()
+{
+    return AUDIOPLUGINBETA_POSIX_SHM != 0;
+}
+
+bool AnalyzerExport::open(const std::vector<float>& gridFrequencies, double sampleRate)
+{
+    using namespace AnalyzerExportLayout;
+
+    const auto numPoints = (std::uint32_t)gridFrequencies.size();
+
+    if (header != nullptr && header->numPoints == numPoints && header->sampleRate == sampleRate)
+        return true;
+
+    close();
+
+   #if AUDIOPLUGINBETA_POSIX_SHM
+    const auto size = getSegmentSize(numPoints, defaultNumFrames);
+
+    // tên còn sót lại từ process cũ cùng pid: tạo mới
+    shm_unlink(name.toRawUTF8());
+
+    auto fd = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return false;
+
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+        mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // mapping giữ segment, fd không cần nữa
+    ::close(fd);
+
+    if (mapped == MAP_FAILED) {
+        shm_unlink(name.toRawUTF8());
+        return false;
+    }
+
+    segment = mapped;
+    segmentSize = size;
+
+    // ftruncate đã xoá về 0: dựng header + các atomic tại chỗ
+    header = new (segment) Header();
+    header->magic = magic;
+    header->version = version;
+    header->numPoints = numPoints;
+    header->numFrames = defaultNumFrames;
+    header->gridOffset = getGridOffset();
+    header->framesOffset = getFramesOffset(numPoints);
+    header->frameStride = getFrameStride(numPoints);
+    header->segmentSize = size;
+    header->sampleRate = sampleRate;
+    header->minDecibels = exportMinDecibels;
+    header->ownerPid = (std::uint32_t)getpid();
+
+    std::copy(gridFrequencies.begin(), gridFrequencies.end(),
+        reinterpret_cast<float*>(static_cast<char*>(segment) + header->gridOffset));
+
+    sequence = 0;
+    for (std::uint64_t slot = 1; slot <= defaultNumFrames; ++slot)
+        new (getSlot(slot)) Frame();
+
+    header->lastSequence.store(0, std::memory_order_relaxed);
+    // reader thấy active = 1 thì mọi trường ở trên đã có
+    header->active.store(1, std::memory_order_release);
+    return true;
+   #else
+    juce::ignoreUnused(sampleRate);
+    return false;
+   #endif
+}
+
+void AnalyzerExport::close()
+{
+    if (header == nullptr)
+        return;
+
+   #if AUDIOPLUGINBETA_POSIX_SHM
+    header->active.store(0, std::memory_order_release);
+
+    munmap(segment, segmentSize);
+    shm_unlink(name.toRawUTF8());
+   #endif
+
+    segment = nullptr;
+    segmentSize = 0;
+    header = nullptr;
+}
+
+AnalyzerExportLayout::Frame* AnalyzerExport::getSlot(std::uint64_t frameSequence) const
+{
+    auto index = (frameSequence - 1) % header->numFrames;
+    return reinterpret_cast<AnalyzerExportLayout::Frame*>(
+        static_cast<char*>(segment) + header->framesOffset + index * header->frameStride);
+}
+
+void AnalyzerExport::publish(const std::vector<float>& post, const std::vector<float>* pre, const Levels& levels)
+{
+    using namespace AnalyzerExportLayout;
+
+    if (header == nullptr)
+        return;
+
+   #if AUDIOPLUGINBETA_POSIX_SHM
+    const auto frameSequence = ++sequence;
+    auto* frame = getSlot(frameSequence);
+
+    // seqlock: reader thấy 0 (hoặc số khác n) thì bỏ bản copy
+    frame->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    frame->timeNs = (std::uint64_t)now.tv_sec * 1000000000ull + (std::uint64_t)now.tv_nsec;
+
+    frame->flags = (pre != nullptr ? hasPreSpectrum : 0u)
+        | (levels.hasCorrelation ? hasCorrelation : 0u)
+        | (levels.hasLoudness ? hasLoudness : 0u);
+
+    frame->momentary = levels.momentary;
+    frame->shortTerm = levels.shortTerm;
+    frame->integrated = levels.integrated;
+    frame->truePeak = levels.truePeak;
+    frame->correlation = levels.correlation;
+
+    const auto numPoints = header->numPoints;
+    writeDecibels(getPostSpectrum(frame), post, numPoints);
+
+    if (pre != nullptr)
+        writeDecibels(getPreSpectrum(frame, numPoints), *pre, numPoints);
+    else
+        std::fill(getPreSpectrum(frame, numPoints), getPreSpectrum(frame, numPoints) + numPoints, exportMinDecibels);
+
+    frame->sequence.store(frameSequence, std::memory_order_release);
+    header->lastSequence.store(frameSequence, std::memory_order_release);
+   #else
+    juce::ignoreUnused(post, pre, levels);
+   #endif
+}
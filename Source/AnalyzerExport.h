@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    AnalyzerExport.h
+
+    Optional publisher of finished analyzer frames (post / pre-EQ spectra on
+    the analyzer grid, loudness and correlation) into a POSIX shared-memory
+    ring, so a local monitoring tool can read them zero-copy instead of
+    analysing the audio again. The layout and sequence protocol are in
+    AnalyzerExportLayout.h. Only the message thread touches it; on platforms
+    without POSIX shared memory open() fails and publish() does nothing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "AnalyzerExportLayout.h"
+
+class AnalyzerExport
+{
+public:
+    // ~1 giây lịch sử ở tốc độ khung của analyzer
+    static constexpr std::uint32_t defaultNumFrames = 64;
+
+    struct Levels
+    {
+        bool hasLoudness = false, hasCorrelation = false;
+        float momentary = 0.f, shortTerm = 0.f, integrated = 0.f, truePeak = 0.f;
+        float correlation = 0.f;
+    };
+
+    AnalyzerExport();
+    ~AnalyzerExport();
+
+    // có POSIX shared memory (Linux / macOS): không có thì editor tắt nút "Export"
+    static bool isSupported();
+
+    // tạo (hoặc giữ) segment cho lưới + sample rate này, tạo lại khi một trong hai đổi
+    bool open(const std::vector<float>& gridFrequencies, double sampleRate);
+    // unlink segment, reader đang map vẫn đọc được tới khi tự đóng (active = 0)
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+
+    // tên shm_open ("/apb.ax.<pid>.<instance>")
+    const juce::String& getName() const { return name; }
+
+    // biên độ tuyến tính trên lưới; pre == nullptr: phổ trước EQ không có trong khung này
+    void publish(const std::vector<float>& post, const std::vector<float>* pre, const Levels& levels);
+
+private:
+    juce::String name;
+
+    void* segment = nullptr;
+    std::size_t segmentSize = 0;
+    AnalyzerExportLayout::Header* header = nullptr;
+
+    std::uint64_t sequence = 0;
+
+    AnalyzerExportLayout::Frame* getSlot(std::uint64_t frameSequence) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerExport)
+};
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    AnalyzerExportLayout.h
+
+    Binary layout of the analyzer export ring, a POSIX shared-memory
+    segment written by AnalyzerExport and read zero-copy by external local
+    tools (see Tools/AnalyzerExportReader). Plain C++17 without JUCE so a
+    reader can include it as is.
+
+    Name:  "/apb.ax.<pid>.<instance>"
+           (on Linux: /dev/shm/apb.ax.<pid>.<instance>; kept short because
+           macOS limits shm names to 31 characters, PSHMNAMLEN)
+    Only built on Linux and macOS; elsewhere the plugin has no export.
+
+    Segment (native byte order, every block 64-byte aligned):
+        Header
+        grid:   numPoints x float32, Hz, log-spaced 20 Hz .. 20 kHz
+        slots:  numFrames x frameStride bytes, each
+                    Frame
+                    post:  numPoints x float32, dB (post-EQ, L / R power average)
+                    pre:   numPoints x float32, dB (pre-EQ, valid with hasPreSpectrum)
+                Spectra are clamped to Header::minDecibels.
+
+    Sequence protocol (one seqlock per slot, frames numbered from 1):
+        writer: slot.sequence = 0, release fence, payload,
+                slot.sequence = n (release), header.lastSequence = n (release)
+        reader: n = header.lastSequence (acquire), slot = (n - 1) % numFrames,
+                s1 = slot.sequence (acquire), copy, acquire fence,
+                s2 = slot.sequence; the copy is valid iff s1 == s2 == n.
+        A jump of k > 1 between two valid reads means k - 1 frames were missed.
+
+    Lifetime: frames come from the editor's analyzer, not from the audio
+    thread. A segment exists only while the plugin editor is open with the
+    analyzer on and "Analyzer Export" enabled; closing the editor (or
+    turning either off) sets active = 0 and unlinks it, and reopening the
+    editor creates it again under the same name. There is no export from a
+    headless session.
+
+    Readers must wait for active == 1 (acquire) before trusting any other
+    header field, then check numFrames > 0 and that the grid and every slot
+    fit inside segmentSize, and segmentSize inside the mapping.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AnalyzerExportLayout
+{
+    constexpr std::uint32_t magic = 0x41504241; // "APBA"
+    constexpr std::uint32_t version = 1;
+
+    // + pid + "." + instance vẫn dưới 31 ký tự của macOS
+    constexpr const char* namePrefix = "/apb.ax.";
+
+    // atomics nằm trong vùng nhớ dùng chung giữa các process: phải lock-free
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared ring needs lock-free 64-bit atomics");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "shared ring needs lock-free 32-bit atomics");
+
+    struct alignas(64) Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t numPoints;
+        std::uint32_t numFrames;
+
+        // byte tính từ đầu segment
+        std::uint64_t gridOffset;
+        std::uint64_t framesOffset;
+        std::uint64_t frameStride;
+        std::uint64_t segmentSize;
+
+        double sampleRate;
+        float minDecibels;
+        std::uint32_t ownerPid;
+
+        // frame mới nhất đã ghi xong, 0 khi chưa có
+        std::atomic<std::uint64_t> lastSequence;
+        // 1 khi publisher còn sống, 0 sau khi đóng (segment bị unlink ngay sau đó)
+        std::atomic<std::uint32_t> active;
+    };
+
+    enum FrameFlags : std::uint32_t
+    {
+        hasPreSpectrum = 1 << 0,
+        hasCorrelation = 1 << 1,
+        hasLoudness = 1 << 2
+    };
+
+    struct alignas(64) Frame
+    {
+        // 0 khi đang ghi, n khi frame n đã ghi xong
+        std::atomic<std::uint64_t> sequence;
+
+        // CLOCK_MONOTONIC (ns) lúc phân tích
+        std::uint64_t timeNs;
+        std::uint32_t flags;
+
+        // LUFS / dBTP, -inf khi chưa đủ dữ liệu (hasLoudness)
+        float momentary, shortTerm, integrated, truePeak;
+
+        // -1 .. +1 (hasCorrelation)
+        float correlation;
+    };
+
+    constexpr std::size_t alignment = 64;
+
+    constexpr std::size_t alignUp(std::size_t size) { return (size + alignment - 1) / alignment * alignment; }
+
+    constexpr std::size_t getGridOffset() { return alignUp(sizeof(Header)); }
+
+    constexpr std::size_t getFramesOffset(std::uint32_t numPoints)
+    {
+        return getGridOffset() + alignUp(numPoints * sizeof(float));
+    }
+
+    constexpr std::size_t getFrameStride(std::uint32_t numPoints)
+    {
+        return alignUp(sizeof(Frame) + 2 * numPoints * sizeof(float));
+    }
+
+    constexpr std::size_t getSegmentSize(std::uint32_t numPoints, std::uint32_t numFrames)
+    {
+        return getFramesOffset(numPoints) + numFrames * getFrameStride(numPoints);
+    }
+
+    // phổ sau / trước EQ nằm ngay sau Frame trong cùng slot
+    inline float* getPostSpectrum(Frame* frame) { return reinterpret_cast<float*>(frame + 1); }
+    inline float* getPreSpectrum(Frame* frame, std::uint32_t numPoints) { return getPostSpectrum(frame) + numPoints; }
+    inline const float* getPostSpectrum(const Frame* frame) { return reinterpret_cast<const float*>(frame + 1); }
+    inline const float* getPreSpectrum(const Frame* frame, std::uint32_t numPoints) { return getPostSpectrum(frame) + numPoints; }
+}
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    AnalyzerPipeline.cpp
+
+  ==============================================================================
+*/
+
+#include "AnalyzerPipeline.h"
+
+AnalyzerPipeline::AnalyzerPipeline(AnalyzerFifos& analyzerFifos)
+    : fifos(analyzerFifos),
+      taps{ &analyzerFifos.preLeftChannelFifo, &analyzerFifos.preRightChannelFifo,
+            &analyzerFifos.leftChannelFifo, &analyzerFifos.rightChannelFifo }
+{
+    fftData.assign((size_t)2 << levelFFTOrder, 0.f);
+
+    gridFrequencies = makeGridFrequencies();
+
+    for (auto& magnitude : magnitudes)
+        magnitude.assign((size_t)gridSize, 0.f);
+
+    smoothedPrePower.assign((size_t)gridSize, 0.f);
+    smoothedPostPower.assign((size_t)gridSize, 0.f);
+    traceData.assign((size_t)gridSize, 0.f);
+    spectrum.assign((size_t)gridSize, 0.f);
+    inputSpectrum.assign((size_t)gridSize, 0.f);
+}
+
+std::vector<float> AnalyzerPipeline::makeGridFrequencies()
+{
+    std::vector<float> frequencies((size_t)gridSize);
+    for (int i = 0; i < gridSize; ++i)
+        frequencies[(size_t)i] = juce::mapToLog10((float)i / float(gridSize - 1), 20.f, 20000.f);
+
+    return frequencies;
+}
+
+void AnalyzerPipeline::prepare(double sampleRate)
+{
+    preparedSampleRate = sampleRate;
+
+    const auto numLevels = MultiResolutionSpectrum::getNumLevelsFor(sampleRate);
+    for (auto& spectrum : spectra)
+        spectrum.prepare(sampleRate, levelFFTOrder, numLevels, gridFrequencies);
+
+    for (auto& magnitude : magnitudes)
+        std::fill(magnitude.begin(), magnitude.end(), 0.f);
+
+    std::fill(smoothedPrePower.begin(), smoothedPrePower.end(), 0.f);
+    std::fill(smoothedPostPower.begin(), smoothedPostPower.end(), 0.f);
+
+    stereo.prepare(sampleRate, gridFrequencies);
+}
+
+void AnalyzerPipeline::setStereoAnalysisEnabled(bool shouldAnalyse)
+{
+    // bật lại: không vẽ tương quan cũ từ lúc tắt
+    if (shouldAnalyse && !stereoAnalysisEnabled)
+        stereo.reset();
+
+    stereoAnalysisEnabled = shouldAnalyse;
+}
+
+bool AnalyzerPipeline::process(juce::Rectangle<float> fftBounds, double sampleRate)
+{
+    if (sampleRate <= 0)
+        return false;
+
+    if (sampleRate != preparedSampleRate)
+        prepare(sampleRate);
+
+    // cả 4 tap được nạp cùng lúc: xả cùng số block để giữ thẳng hàng
+    auto available = taps[0]->getNumCompleteBuffersAvailable();
+    for (auto* tap : taps)
+        available = juce::jmin(available, tap->getNumCompleteBuffersAvailable());
+
+    for (int block = 0; block < available; ++block) {
+        for (int tap = 0; tap < numTaps; ++tap) {
+            auto& incoming = incomingBuffers[(size_t)tap];
+            if (taps[(size_t)tap]->getAudioBuffer(incoming) && (preAnalysisEnabled || !isPreTap(tap)))
+                spectra[(size_t)tap].push(incoming.getReadPointer(0), incoming.getNumSamples());
+        }
+
+        const auto& left = incomingBuffers[PostLeftTap];
+        const auto& right = incomingBuffers[PostRightTap];
+        if (stereoAnalysisEnabled && left.getNumSamples() == right.getNumSamples())
+            stereo.push(left.getReadPointer(0), right.getReadPointer(0), left.getNumSamples());
+    }
+
+    if (available == 0)
+        return false;
+
+    // chỉ cửa sổ mới nhất của mỗi tầng được vẽ: mỗi tap phân tích 1 lần cho cả khung hình
+    for (int tap = 0; tap < numTaps; ++tap) {
+        if (isPreTap(tap) && !preAnalysisEnabled)
+            continue;
+
+        spectra[(size_t)tap].analyse(forwardFFT, window, fftData, magnitudes[(size_t)tap]);
+    }
+
+    updateTraces(fftBounds);
+
+    if (stereoAnalysisEnabled)
+        stereo.updateBands(spectra[PostLeftTap], spectra[PostRightTap]);
+
+    return true;
+}
+
+void AnalyzerPipeline::updateTraces(juce::Rectangle<float> fftBounds)
+{
+
+    auto toDecibels = [](float gain) { return juce::Decibels::gainToDecibels(gain, negativeInfinity); };
+
+    for (auto [trace, tap] : { std::pair<int, int>{ PostLeft, PostLeftTap }, std::pair<int, int>{ PostRight, PostRightTap } }) {
+        const auto& magnitude = magnitudes[(size_t)tap];
+        for (int i = 0; i < gridSize; ++i)
+            traceData[(size_t)i] = toDecibels(magnitude[(size_t)i]);
+
+        generatePath(paths[(size_t)trace], traceData, fftBounds, negativeInfinity, 0.f);
+    }
+
+    const auto& postLeft = magnitudes[PostLeftTap];
+    const auto& postRight = magnitudes[PostRightTap];
+
+    for (int i = 0; i < gridSize; ++i)
+        spectrum[(size_t)i] = std::sqrt(0.5f * (postLeft[(size_t)i] * postLeft[(size_t)i] + postRight[(size_t)i] * postRight[(size_t)i]));
+
+    if (!preAnalysisEnabled) {
+        paths[Pre].clear();
+        paths[Difference].clear();
+        return;
+    }
+
+    const auto& preLeft = magnitudes[PreLeftTap];
+    const auto& preRight = magnitudes[PreRightTap];
+
+    // đường pre: trung bình công suất 2 kênh
+    for (int i = 0; i < gridSize; ++i) {
+        auto prePower = 0.5f * (preLeft[(size_t)i] * preLeft[(size_t)i] + preRight[(size_t)i] * preRight[(size_t)i]);
+        auto postPower = spectrum[(size_t)i] * spectrum[(size_t)i];
+
+        inputSpectrum[(size_t)i] = std::sqrt(prePower);
+        traceData[(size_t)i] = toDecibels(inputSpectrum[(size_t)i]);
+
+        // làm mượt theo thời gian trước khi lấy tỉ số, điểm nhiễu không nhảy lung tung
+        smoothedPrePower[(size_t)i] += 0.3f * (prePower - smoothedPrePower[(size_t)i]);
+        smoothedPostPower[(size_t)i] += 0.3f * (postPower - smoothedPostPower[(size_t)i]);
+    }
+
+    generatePath(paths[Pre], traceData, fftBounds, negativeInfinity, 0.f);
+
+    // điểm mà input gần như im lặng không nói gì về EQ: vẽ ở 0 dB
+    const auto floorPower = juce::Decibels::decibelsToGain(2.f * negativeInfinity);
+    for (int i = 0; i < gridSize; ++i) {
+        auto prePower = smoothedPrePower[(size_t)i];
+        auto difference = prePower > floorPower
+            ? 10.f * std::log10(juce::jmax(smoothedPostPower[(size_t)i], floorPower) / prePower)
+            : 0.f;
+
+        traceData[(size_t)i] = juce::jlimit(-differenceRange, differenceRange, difference);
+    }
+
+    generatePath(paths[Difference], traceData, fftBounds, -differenceRange, differenceRange);
+}
+
+void AnalyzerPipeline::generatePath(juce::Path& path, const std::vector<float>& values, juce::Rectangle<float> fftBounds,
+    float minValue, float maxValue) const
+{
+    // cùng hệ toạ độ với bản cũ: x từ 0, path được dịch vào vùng analysis lúc vẽ
+    auto top = fftBounds.getY();
+    auto bottom = fftBounds.getHeight();
+    auto width = fftBounds.getWidth();
+
+    const auto numPoints = (int)values.size();
+
+    path.clear();
+    path.preallocateSpace(3 * numPoints);
+
+    auto map = [bottom, top, minValue, maxValue](float v) {
+        return juce::jmap(v, minValue, maxValue, float(bottom), top);
+    };
+
+    auto y = map(values[0]);
+    if (!std::isfinite(y))
+        y = bottom;
+
+    path.startNewSubPath(0, y);
+
+    // lưới đã log đều: mỗi điểm một lineTo, mật độ đều trên trục x
+    for (int i = 1; i < numPoints; ++i) {
+        y = map(values[(size_t)i]);
+
+        if (std::isfinite(y)) {
+            auto normalizedX = juce::mapFromLog10(gridFrequencies[(size_t)i], 20.f, 20000.f);
+            path.lineTo(normalizedX * width, y);
+        }
+    }
+}
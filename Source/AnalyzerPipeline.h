@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    AnalyzerPipeline.h
+
+    One analysis pass for every analyzer tap of the processor (post-EQ left
+    and right, pre-EQ left and right). Blocks are pulled from all taps in
+    lock-step into per-tap multi-resolution spectra, then each tap is
+    analysed at most once per GUI frame on its newest windows, sharing a
+    single FFT object, window table and scratch buffer, instead of one FFT
+    per incoming block in independent producers. All traces live on one
+    log-frequency grid. The pre-EQ spectrum and the post/pre difference
+    (what the EQ is actually doing to the signal) come from the same pass,
+    and so does the stereo stage, which sees both post-EQ channels together.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PluginProcessor.h"
+#include "MultiResolutionSpectrum.h"
+#include "StereoAnalysis.h"
+
+struct AnalyzerPipeline
+{
+    enum Trace {
+        PostLeft,
+        PostRight,
+        Pre,            // trung bình công suất L / R trước EQ
+        Difference,     // sau EQ - trước EQ (dB), 0 dB ở giữa
+        NumTraces
+    };
+
+    // phổ: -48 dB .. 0 dB, chênh lệch: +-24 dB giống thang của đường phản hồi
+    static constexpr float negativeInfinity = -48.f;
+    static constexpr float differenceRange = 24.f;
+
+    // cỡ FFT của mỗi tầng (1024): tầng sâu nhất ở 48 kHz có bin 5.9 Hz như một FFT 8192 điểm
+    static constexpr int levelFFTOrder = 10;
+    // số điểm của lưới log 20 Hz .. 20 kHz
+    static constexpr int gridSize = 384;
+
+    explicit AnalyzerPipeline(AnalyzerFifos& analyzerFifos);
+
+    // lưới log đều 20 Hz .. 20 kHz (gridSize điểm), trùng trục x của đường phản hồi
+    static std::vector<float> makeGridFrequencies();
+    const std::vector<float>& getGridFrequencies() const { return gridFrequencies; }
+
+    // tap trước EQ chỉ được phân tích khi có đường pre hoặc chênh lệch cần vẽ
+    void setPreAnalysisEnabled(bool shouldAnalyse) { preAnalysisEnabled = shouldAnalyse; }
+    bool isPreAnalysisEnabled() const { return preAnalysisEnabled; }
+
+    // tương quan / goniometer / pha theo dải, chỉ chạy khi có meter cần vẽ
+    void setStereoAnalysisEnabled(bool shouldAnalyse);
+    bool isStereoAnalysisEnabled() const { return stereoAnalysisEnabled; }
+    const StereoAnalysis& getStereoAnalysis() const { return stereo; }
+
+    // xả block mới của cả 4 tap rồi phân tích 1 lượt, dựng lại path nếu có dữ liệu mới (trả về true)
+    bool process(juce::Rectangle<float> fftBounds, double sampleRate);
+
+    const juce::Path& getPath(Trace trace) const { return paths[(size_t)trace]; }
+
+    // biên độ sau EQ (trung bình công suất L / R) trên lưới của lần phân tích gần nhất
+    const std::vector<float>& getSpectrum() const { return spectrum; }
+
+    // biên độ trước EQ (trung bình công suất L / R), chỉ cập nhật khi tap trước EQ được phân tích
+    const std::vector<float>& getInputSpectrum() const { return inputSpectrum; }
+
+    // block bị bỏ ở các tap vì GUI không đọc kịp
+    juce::uint32 getNumDroppedBlocks() const { return fifos.getNumDroppedBuffers(); }
+
+private:
+    static constexpr int numTaps = 4;
+    enum Tap { PreLeftTap, PreRightTap, PostLeftTap, PostRightTap };
+
+    AnalyzerFifos& fifos;
+    std::array<SingleChannelSampleFifo<AnalyzerFifos::BlockType>*, numTaps> taps;
+
+    bool preAnalysisEnabled = false, stereoAnalysisEnabled = false;
+
+    // dùng chung cho mọi tap và mọi tầng
+    juce::dsp::FFT forwardFFT{ levelFFTOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t)1 << levelFFTOrder, juce::dsp::WindowingFunction<float>::blackmanHarris };
+    std::vector<float> fftData;
+
+    // block vừa xả của từng tap (stage stereo cần 2 tap sau EQ cùng lúc)
+    std::array<AnalyzerFifos::BlockType, numTaps> incomingBuffers;
+
+    // dựng lại các tầng khi sample rate đổi
+    double preparedSampleRate = 0;
+    std::vector<float> gridFrequencies;
+
+    // phổ nhiều tầng của mỗi tap, biên độ (tuyến tính) trên lưới log của lần phân tích gần nhất
+    std::array<MultiResolutionSpectrum, numTaps> spectra;
+    std::array<std::vector<float>, numTaps> magnitudes;
+
+    // công suất trước / sau EQ làm mượt qua các khung, cho đường chênh lệch đỡ nhiễu
+    std::vector<float> smoothedPrePower, smoothedPostPower;
+    std::vector<float> traceData, spectrum, inputSpectrum;
+
+    std::array<juce::Path, NumTraces> paths;
+
+    StereoAnalysis stereo;
+
+    static bool isPreTap(int tap) { return tap == PreLeftTap || tap == PreRightTap; }
+
+    void prepare(double sampleRate);
+    void updateTraces(juce::Rectangle<float> fftBounds);
+
+    // values theo điểm lưới, ánh xạ [minValue, maxValue] lên chiều cao fftBounds
+    void generatePath(juce::Path& path, const std::vector<float>& values, juce::Rectangle<float> fftBounds,
+        float minValue, float maxValue) const;
+};
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    BiquadFilter.h
+
+    Drop-in replacement for juce::dsp::IIR::Filter restricted to second-order
+    sections (every cut / peak stage in the chain is a biquad). Same public
+    surface (coefficients pointer, prepare / reset / process / processSample)
+    so it sits in a ProcessorChain unchanged, but the TDF-II state is kept
+    denormal-free by construction: a tiny DC offset is added to the input of
+    the section, so decaying tails settle on a normal constant instead of
+    relying on FTZ/DAZ being set by ScopedNoDenormals.
+    Tools/DenormalBenchmark times it against the plain section on a decaying tail.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "FilterDesign.h"
+
+// keepStateNormal = false chỉ dùng để đo (Tools/DenormalBenchmark): TDF-II trần, không cộng offset
+template<typename SampleType, bool keepStateNormal = true>
+struct BiquadFilter
+{
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+    using CoefficientsPtr = typename Coefficients::Ptr;
+
+    // luôn trỏ tới một biquad 5 hệ số { b0, b1, b2, a1, a2 }, mặc định đi thẳng
+    CoefficientsPtr coefficients{ new Coefficients(1, 0, 0, 1, 0, 0) };
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        jassert(spec.numChannels == 1);
+        juce::ignoreUnused(spec);
+
+        reset();
+    }
+
+    void reset()
+    {
+        s1 = s2 = 0;
+    }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context)
+    {
+        auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+
+        jassert(outputBlock.getNumChannels() == 1);
+
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom(inputBlock);
+
+        if (context.isBypassed)
+            return;
+
+        auto* samples = outputBlock.getChannelPointer(0);
+        processSamples((int)outputBlock.getNumSamples(),
+            [samples](int i) { return samples[i]; },
+            [samples](int i, SampleType y) { samples[i] = y; });
+    }
+
+    // Mid/Side: tầng đầu của chain mid đọc thẳng L/R và encode ngay trong vòng lặp của tầng,
+    // mid đã lọc ghi vào left, side chưa lọc ghi vào right cho chain side
+    void processEncodingMidSide(SampleType* left, SampleType* right, int numSamples)
+    {
+        processSamples(numSamples,
+            [left, right](int i) { return (SampleType)0.5 * (left[i] + right[i]); },
+            [left, right](int i, SampleType y) {
+                right[i] = (SampleType)0.5 * (left[i] - right[i]);
+                left[i] = y;
+            });
+    }
+
+    SampleType processSample(SampleType x)
+    {
+        const auto* c = coefficients->getRawCoefficients();
+
+        if constexpr (keepStateNormal)
+            x += antiDenormal<SampleType>;
+
+        auto y = c[0] * x + s1;
+        s1 = c[1] * x - c[3] * y + s2;
+        s2 = c[2] * x - c[4] * y;
+        return y;
+    }
+
+private:
+    SampleType s1 = 0, s2 = 0;
+
+    // read(i) -> x, write(i, y): hệ số + trạng thái ra biến cục bộ cho cả block
+    template<typename Read, typename Write>
+    void processSamples(int numSamples, Read&& read, Write&& write)
+    {
+        jassert(coefficients->coefficients.size() == 5);
+        const auto* c = coefficients->getRawCoefficients();
+        const auto b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        auto z1 = s1, z2 = s2;
+
+        for (int i = 0; i < numSamples; ++i) {
+            auto x = read(i);
+            if constexpr (keepStateNormal)
+                x += antiDenormal<SampleType>;
+
+            auto y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            write(i, y);
+        }
+
+        s1 = z1;
+        s2 = z2;
+    }
+};
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    BypassFader.cpp
+
+  ==============================================================================
+*/
+
+#include "BypassFader.h"
+
+template<typename SampleType>
+void BypassFader<SampleType>::prepare(double newSampleRate, int maximumBlockSize, int numChannels)
+{
+    sampleRate = newSampleRate;
+
+    dry.setSize(numChannels, maximumBlockSize, false, true, true);
+
+    // tính lại độ dài fade theo sample rate mới
+    auto ms = fadeMs;
+    fadeMs = -1.f;
+    setFadeLength(juce::jmax(0.f, ms));
+
+    reset(!active);
+}
+
+template<typename SampleType>
+void BypassFader<SampleType>::reset(bool bypassed)
+{
+    active = !bypassed;
+    position = active ? fadeLength : 0;
+}
+
+template<typename SampleType>
+void BypassFader<SampleType>::setFadeLength(float milliseconds)
+{
+    if (milliseconds == fadeMs)
+        return;
+
+    fadeMs = milliseconds;
+    auto newLength = juce::roundToInt(sampleRate * milliseconds * 0.001);
+
+    // giữ nguyên tỉ lệ đang fade dở
+    position = fadeLength > 0 ? juce::roundToInt((double)position * newLength / fadeLength)
+                              : (active ? newLength : 0);
+    fadeLength = newLength;
+}
+
+template<typename SampleType>
+void BypassFader<SampleType>::setBypassed(bool shouldBeBypassed)
+{
+    active = !shouldBeBypassed;
+}
+
+template<typename SampleType>
+void BypassFader<SampleType>::storeDry(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), dry.getNumChannels());
+    jassert(numSamples <= dry.getNumSamples());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        dry.copyFrom(channel, 0, buffer, channel, startSample, juce::jmin(numSamples, dry.getNumSamples()));
+}
+
+template<typename SampleType>
+void BypassFader<SampleType>::mixDry(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), dry.getNumChannels());
+    numSamples = juce::jmin(numSamples, dry.getNumSamples());
+    const auto step = active ? 1 : -1;
+    const auto startPosition = position;
+
+    // mọi kênh đi cùng một đường fade
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto* wet = buffer.getWritePointer(channel, startSample);
+        const auto* in = dry.getReadPointer(channel);
+        auto pos = startPosition;
+
+        for (int i = 0; i < numSamples; ++i) {
+            pos = juce::jlimit(0, fadeLength, pos + step);
+            auto angle = juce::MathConstants<SampleType>::halfPi * (SampleType)pos / (SampleType)juce::jmax(1, fadeLength);
+            wet[i] = wet[i] * std::sin(angle) + in[i] * std::cos(angle);
+        }
+    }
+
+    position = juce::jlimit(0, fadeLength, startPosition + step * numSamples);
+}
+
+template struct BypassFader<float>;
+template struct BypassFader<double>;
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    BypassFader.h
+
+    Host-level bypass with an equal-power crossfade between the processed and
+    the dry signal. Once the fade-out has finished the processor skips the
+    whole chain, so a bypassed instance costs almost nothing. Optionally every
+    bypassed block is still run through the chain (a copy, in chunks through
+    the dry buffer) so the filter state follows the signal and re-enabling
+    starts from a warm state; that option costs as much CPU as not bypassing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+template<typename SampleType>
+struct BypassFader
+{
+    void prepare(double newSampleRate, int maximumBlockSize, int numChannels);
+
+    // nhảy thẳng tới trạng thái, không fade
+    void reset(bool bypassed);
+
+    void setFadeLength(float milliseconds);
+    void setBypassed(bool shouldBeBypassed);
+
+    // fade-out đã xong: không cần chạy DSP
+    bool isFullyBypassed() const { return !active && position == 0; }
+    bool isFading() const { return active ? position < fadeLength : position > 0; }
+
+    // số sample tối đa của 1 đoạn storeDry / mixDry (block size lúc prepare),
+    // block của host dài hơn thì chia đoạn
+    int getMaximumChunkSize() const { return juce::jmax(1, dry.getNumSamples()); }
+
+    // lưu đoạn [startSample, startSample + numSamples) trước khi chain ghi đè (chỉ cần khi đang fade),
+    // numSamples <= getMaximumChunkSize()
+    void storeDry(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+
+    // trộn đoạn vừa lưu, equal-power: wet * sin(p pi / 2) + dry * cos(p pi / 2), p = position / fadeLength
+    void mixDry(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+
+    // đã bypass hẳn thì bộ đệm dry rảnh: dùng làm chỗ chạy chain giữ trạng thái ấm
+    juce::AudioBuffer<SampleType>& getScratchBuffer() { return dry; }
+
+    // bộ đệm dry (byte)
+    size_t getMemoryUsage() const
+    {
+        return (size_t)(dry.getNumChannels() * dry.getNumSamples()) * sizeof(SampleType);
+    }
+
+private:
+    juce::AudioBuffer<SampleType> dry;
+
+    double sampleRate = 44100.0;
+    float fadeMs = -1.f;
+
+    // 0 = khô hoàn toàn, fadeLength = chỉ có tín hiệu đã xử lý
+    int fadeLength = 0, position = 0;
+    bool active = true;
+};
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.cpp
+
+  ==============================================================================
+*/
+
+#include "CoefficientCache.h"
+
+namespace
+{
+    double exactG(double frequency, double sampleRate)
+    {
+        auto f = juce::jlimit(1.0, 0.49 * sampleRate, frequency);
+        return std::tan(juce::MathConstants<double>::pi * f / sampleRate);
+    }
+}
+
+PrewarpTable::Ptr PrewarpTable::getForSampleRate(double sampleRate)
+{
+    static juce::CriticalSection lock;
+    static juce::ReferenceCountedArray<PrewarpTable> cache;
+
+    const juce::ScopedLock sl(lock);
+
+    for (auto* table : cache)
+        if (table->sampleRate == sampleRate)
+            return table;
+
+    // giới hạn bộ nhớ: bỏ các bảng không instance nào còn dùng
+    if (cache.size() >= maxCachedTables)
+        for (int i = cache.size(); --i >= 0;)
+            if (cache.getObjectPointerUnchecked(i)->getReferenceCount() == 1)
+                cache.remove(i);
+
+    Ptr table = new PrewarpTable(sampleRate);
+
+    // vẫn đầy (mọi bảng đều đang được dùng): trả về bảng riêng, không cache
+    if (cache.size() < maxCachedTables)
+        cache.add(table);
+
+    return table;
+}
+
+PrewarpTable::PrewarpTable(double newSampleRate)
+    : sampleRate(newSampleRate),
+      minFrequency(std::ldexp(1.0, minExponent)),
+      maxFrequency(maxTableRatio * newSampleRate)
+{
+    // đủ octave để phủ tới maxFrequency, +1 ô cuối cho nội suy
+    int maxExponent = 0;
+    std::frexp(maxFrequency, &maxExponent);
+    auto numOctaves = juce::jmax(1, maxExponent - minExponent);
+
+    table.resize((size_t)(numOctaves * pointsPerOctave + 1));
+
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+        auto octave = (int)i / pointsPerOctave;
+        auto step = (int)i % pointsPerOctave;
+        auto frequency = std::ldexp(1.0 + (double)step / pointsPerOctave, minExponent + octave);
+
+        table[i] = exactG(frequency, sampleRate);
+    }
+}
+
+double PrewarpTable::getG(float frequency) const
+{
+    auto f = (double)frequency;
+    if (f < minFrequency || f >= maxFrequency)
+        return exactG(f, sampleRate);
+
+    // f = m * 2^e, m trong [0.5, 1): octave lấy từ số mũ, không cần log()
+    int exponent = 0;
+    auto mantissa = std::frexp(f, &exponent);
+
+    auto position = (double)((exponent - 1 - minExponent) * pointsPerOctave) + (2.0 * mantissa - 1.0) * pointsPerOctave;
+    auto index = (size_t)position;
+    auto frac = position - (double)index;
+
+    jassert(index + 1 < table.size());
+
+    return table[index] + frac * (table[index + 1] - table[index]);
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.h
+
+    Shared table of the bilinear prewarp g = tan(pi f / fs), indexed by
+    quantised log-frequency (octave from the float exponent, linear steps
+    inside the octave) and built lazily once per sample rate. Every bilinear
+    cut section and the RBJ peak can be written in terms of g and a damping
+    k = 1/Q that only depends on the slope, so a frequency sweep becomes a
+    table lookup instead of a tan() / sin() / cos() per design.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct PrewarpTable : juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<PrewarpTable>;
+
+    // dùng chung giữa các instance có cùng sample rate, chỉ giữ tối đa maxCachedTables bảng
+    static Ptr getForSampleRate(double sampleRate);
+
+    explicit PrewarpTable(double sampleRate);
+
+    // g = tan(pi f / fs), nội suy tuyến tính; ngoài vùng bảng (gần Nyquist) thì tính thẳng
+    double getG(float frequency) const;
+
+    double getSampleRate() const { return sampleRate; }
+
+private:
+    static constexpr int maxCachedTables = 4;
+
+    // 16 Hz = 2^4 là ô đầu tiên, 128 điểm mỗi octave
+    static constexpr int minExponent = 4;
+    static constexpr int pointsPerOctave = 128;
+
+    // trên 0.4 fs độ cong của tan tăng nhanh, sai số nội suy vượt ~1e-4
+    static constexpr double maxTableRatio = 0.4;
+
+    double sampleRate;
+    double minFrequency, maxFrequency;
+    std::vector<double> table;
+};
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    DynamicEQ.cpp
+
+  ==============================================================================
+*/
+
+#include "DynamicEQ.h"
+
+void DynamicPeakBand::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    // ép dựng lại bảng và hệ số envelope theo sample rate mới
+    bandFrequency = -1.f;
+    attackMs = -1.f;
+    releaseMs = -1.f;
+
+    reset();
+}
+
+void DynamicPeakBand::reset()
+{
+    z1 = z2 = 0.f;
+    envelope = 0.f;
+    currentGain.store(staticGain);
+}
+
+void DynamicPeakBand::setBand(float frequency, float Q, float staticGainInDecibels, bool analogMatched)
+{
+    staticGain = staticGainInDecibels;
+
+    if (frequency == bandFrequency && Q == bandQuality && analogMatched == bandMatched)
+        return;
+
+    bandFrequency = frequency;
+    bandQuality = Q;
+    bandMatched = analogMatched;
+
+    rebuildTable();
+}
+
+void DynamicPeakBand::setDynamics(float thresholdInDecibels, float ratio, float newAttackMs, float newReleaseMs)
+{
+    threshold = thresholdInDecibels;
+    slope = 1.f - 1.f / juce::jmax(1.f, ratio);
+
+    auto timeToCoefficient = [this](float ms)
+    {
+        return 1.f - std::exp(-1.f / (juce::jmax(0.01f, ms) * 0.001f * (float)sampleRate));
+    };
+
+    if (newAttackMs != attackMs)
+    {
+        attackMs = newAttackMs;
+        attackCoeff = timeToCoefficient(attackMs);
+    }
+
+    if (newReleaseMs != releaseMs)
+    {
+        releaseMs = newReleaseMs;
+        releaseCoeff = timeToCoefficient(releaseMs);
+    }
+}
+
+void DynamicPeakBand::rebuildTable()
+{
+    for (int i = 0; i < tableSize; ++i)
+    {
+        auto gainInDecibels = minGain + gainStep * i;
+        table[i] = designPeakBiquad(sampleRate,
+            bandFrequency,
+            bandQuality,
+            juce::Decibels::decibelsToGain(gainInDecibels),
+            bandMatched);
+    }
+
+    // detector nghe đúng dải mà band đang tác động
+    auto bandPass = designBandPassBiquad(sampleRate, bandFrequency, bandQuality);
+    std::copy(bandPass.begin(), bandPass.end(), detector.begin());
+}
+
+template<typename SampleType>
+float DynamicPeakBand::processDetector(const SampleType* left, const SampleType* right, int numSamples, bool side)
+{
+    const auto b0 = detector[0], b1 = detector[1], b2 = detector[2];
+    const auto a1 = detector[3], a2 = detector[4];
+
+    const auto rightSign = side ? -1.f : 1.f;
+
+    auto s1 = z1, s2 = z2, env = envelope;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto x = right != nullptr ? 0.5f * ((float)left[i] + rightSign * (float)right[i]) : (float)left[i];
+        x += antiDenormal<float>;
+
+        auto y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+
+        // y của band-pass với input im lặng về 0, y * y sẽ rơi vào vùng denormal
+        auto power = y * y + antiDenormal<float>;
+        env += (power > env ? attackCoeff : releaseCoeff) * (power - env);
+    }
+
+    z1 = s1;
+    z2 = s2;
+    envelope = env;
+
+    // chỉ tính log một lần cho mỗi sub-block
+    auto levelInDecibels = 10.f * std::log10(env + 1.0e-12f);
+    auto over = levelInDecibels - threshold;
+    auto gain = staticGain - (over > 0.f ? over * slope : 0.f);
+
+    gain = juce::jlimit(minGain, maxGain, gain);
+    currentGain.store(gain);
+
+    return gain;
+}
+
+template float DynamicPeakBand::processDetector<float>(const float*, const float*, int, bool);
+template float DynamicPeakBand::processDetector<double>(const double*, const double*, int, bool);
+
+RawBiquad DynamicPeakBand::getCoefficientsForGain(float gainInDecibels) const
+{
+    auto position = (juce::jlimit(minGain, maxGain, gainInDecibels) - minGain) / gainStep;
+    auto index = juce::jmin((int)position, tableSize - 2);
+    auto frac = position - (float)index;
+
+    // tập (a1, a2) ổn định là tập lồi nên nội suy giữa hai biquad ổn định vẫn ổn định
+    const auto& lo = table[index];
+    const auto& hi = table[index + 1];
+
+    RawBiquad result;
+    for (size_t i = 0; i < result.size(); ++i)
+        result[i] = lo[i] + frac * (hi[i] - lo[i]);
+
+    return result;
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    DynamicEQ.h
+
+    Dynamic mode for the Peak band: a band-limited envelope detector (input or
+    sidechain) drives the band gain. The peak coefficients come from a table
+    precomputed per (freq, Q, design) and are refreshed every controlInterval
+    samples, so no peak filter is designed per sample.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "FilterDesign.h"
+
+struct DynamicPeakBand
+{
+    // số sample giữa hai lần cập nhật hệ số (control rate)
+    static constexpr int controlInterval = 32;
+
+    void prepare(double newSampleRate);
+    void reset();
+
+    // dựng lại bảng gain -> hệ số chỉ khi freq/Q/kiểu thiết kế thay đổi
+    void setBand(float frequency, float Q, float staticGainInDecibels, bool analogMatched);
+    void setDynamics(float thresholdInDecibels, float ratio, float attackMs, float releaseMs);
+
+    /*
+    chạy detector trên một sub-block (mono = trung bình 2 kênh, right có thể null,
+    side = true thì nghe (L - R) / 2), trả về gain (dB) của band cho sub-block đó.
+    input float hoặc double, detector luôn chạy float (chỉ cần mức năng lượng)
+    */
+    template<typename SampleType>
+    float processDetector(const SampleType* left, const SampleType* right, int numSamples, bool side = false);
+
+    // nội suy tuyến tính giữa hai ô kề nhau của bảng
+    RawBiquad getCoefficientsForGain(float gainInDecibels) const;
+
+    // cho GUI đọc
+    float getCurrentGainInDecibels() const { return currentGain.load(); }
+
+    // backend SVF tự thiết kế tầng peak từ gain, không dùng bảng biquad
+    float getFrequency() const { return bandFrequency; }
+    float getQuality() const { return bandQuality; }
+
+private:
+    static constexpr float minGain = -24.f, maxGain = 24.f, gainStep = 0.5f;
+    static constexpr int tableSize = int((maxGain - minGain) / gainStep) + 1;
+
+    std::array<RawBiquad, tableSize> table;
+
+    double sampleRate = 44100.0;
+    float bandFrequency = -1.f, bandQuality = -1.f;
+    bool bandMatched = false;
+    float staticGain = 0.f;
+
+    // slope = 1 - 1/ratio, giống compressor
+    float threshold = 0.f, slope = 0.f;
+    float attackMs = -1.f, releaseMs = -1.f;
+    float attackCoeff = 1.f, releaseCoeff = 1.f;
+
+    // detector: band-pass TDF-II + envelope trên công suất
+    std::array<float, 5> detector{};
+    float z1 = 0.f, z2 = 0.f;
+    float envelope = 0.f;
+
+    std::atomic<float> currentGain{ 0.f };
+
+    void rebuildTable();
+};
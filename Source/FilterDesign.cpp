@@ -0,0 +1,354 @@
+/*
+  ==============================================================================
+
+    FilterDesign.cpp
+
+  ==============================================================================
+*/
+
+#include "FilterDesign.h"
+
+namespace
+{
+    // |A(e^jw)|^2 = A0 * phi0 + A1 * phi1 + A2 * phi2 (cùng ký hiệu với bài báo)
+    struct Phi
+    {
+        double p0, p1, p2;
+    };
+
+    Phi phiAt(double w)
+    {
+        auto s = std::sin(w * 0.5);
+        auto p1 = s * s;
+        auto p0 = 1.0 - p1;
+        return { p0, p1, 4.0 * p0 * p1 };
+    }
+
+    struct MatchedPoles
+    {
+        double a1, a2;
+        double A0, A1, A2;
+
+        double magnitudeSquared(const Phi& phi) const
+        {
+            return A0 * phi.p0 + A1 * phi.p1 + A2 * phi.p2;
+        }
+    };
+
+    // đặt cực bằng impulse invariance: z = exp(s * T)
+    MatchedPoles matchPoles(double w0, double Q)
+    {
+        auto zeta = 1.0 / (2.0 * Q);
+        auto r = std::exp(-zeta * w0);
+
+        MatchedPoles poles;
+        if (zeta <= 1.0)
+            poles.a1 = -2.0 * r * std::cos(std::sqrt(1.0 - zeta * zeta) * w0);
+        else
+            poles.a1 = -2.0 * r * std::cosh(std::sqrt(zeta * zeta - 1.0) * w0);
+        poles.a2 = r * r;
+
+        poles.A0 = (1.0 + poles.a1 + poles.a2) * (1.0 + poles.a1 + poles.a2);
+        poles.A1 = (1.0 - poles.a1 + poles.a2) * (1.0 - poles.a1 + poles.a2);
+        poles.A2 = -4.0 * poles.a2;
+        return poles;
+    }
+
+    // tần số tâm phải nằm dưới Nyquist, nếu không phi2 -> 0
+    double toNormalisedFrequency(float frequency, double sampleRate)
+    {
+        auto f = juce::jlimit(1.0, 0.49 * sampleRate, (double)frequency);
+        return juce::MathConstants<double>::twoPi * f / sampleRate;
+    }
+
+    // Butterworth bậc chẵn: Q của từng tầng bậc 2 = 1 / (2 cos((2i + 1) pi / 2N)),
+    // tính sẵn cho N = 2, 4, 6, 8 (cùng thứ tự tầng với FilterDesign<float>)
+    constexpr std::array<std::array<double, MaxCutSections>, MaxCutSections> butterworthQ{ {
+        { 0.70710678118654752, 0.0, 0.0, 0.0 },
+        { 0.54119610014619699, 1.30656296487637653, 0.0, 0.0 },
+        { 0.51763809020504152, 0.70710678118654752, 1.93185165257813657, 0.0 },
+        { 0.50979557910415917, 0.60134488693504529, 0.89997622313641570, 2.56291544774150617 }
+    } };
+
+    constexpr double butterworthSectionQ(int section, int order)
+    {
+        return butterworthQ[order / 2 - 1][section];
+    }
+
+    RawBiquad matchedHighPassCoefficients(double sampleRate, float frequency, double Q)
+    {
+        auto w0 = toNormalisedFrequency(frequency, sampleRate);
+        auto poles = matchPoles(w0, Q);
+        auto phi = phiAt(w0);
+
+        // zero kép tại DC, |H(w0)| = Q
+        auto b0 = Q * std::sqrt(poles.magnitudeSquared(phi)) / (4.0 * phi.p1);
+
+        return { b0, -2.0 * b0, b0, poles.a1, poles.a2 };
+    }
+
+    RawBiquad matchedLowPassCoefficients(double sampleRate, float frequency, double Q)
+    {
+        auto w0 = toNormalisedFrequency(frequency, sampleRate);
+        auto poles = matchPoles(w0, Q);
+        auto phi = phiAt(w0);
+
+        // |H(0)| = 1, |H(w0)| = Q, b2 = 0
+        auto B0 = poles.A0;
+        auto R1 = poles.magnitudeSquared(phi) * Q * Q;
+        auto B1 = juce::jmax(0.0, (R1 - B0 * phi.p0) / phi.p1);
+
+        auto b0 = 0.5 * (std::sqrt(B0) + std::sqrt(B1));
+        auto b1 = std::sqrt(B0) - b0;
+
+        return { b0, b1, 0.0, poles.a1, poles.a2 };
+    }
+
+    // cùng công thức với IIR::Coefficients<float>::makeHighPass / makeLowPass
+    RawBiquad butterworthHighPassSection(double n, double Q)
+    {
+        auto n2 = n * n;
+        auto invQ = 1.0 / Q;
+        auto c1 = 1.0 / (1.0 + invQ * n + n2);
+
+        return { c1, -2.0 * c1, c1, c1 * 2.0 * (n2 - 1.0), c1 * (1.0 - invQ * n + n2) };
+    }
+
+    RawBiquad butterworthLowPassSection(double n, double Q)
+    {
+        // n = 1 / tan(pi f / fs)
+        auto n2 = n * n;
+        auto invQ = 1.0 / Q;
+        auto c1 = 1.0 / (1.0 + invQ * n + n2);
+
+        return { c1, 2.0 * c1, c1, c1 * 2.0 * (1.0 - n2), c1 * (1.0 - invQ * n + n2) };
+    }
+
+    std::array<double, 5> matchedPeakCoefficients(double sampleRate, float frequency, float Q, float gainFactor)
+    {
+        auto w0 = toNormalisedFrequency(frequency, sampleRate);
+
+        // nguyên mẫu analog (RBJ): H(s) = (s^2 + s*A/Q + 1) / (s^2 + s/(A*Q) + 1), A = sqrt(G)
+        auto A = std::sqrt(juce::jmax(1.0e-6, (double)gainFactor));
+        auto q = juce::jmax(1.0e-3, (double)Q);
+
+        auto analogMagnitudeSquared = [A, q](double x)
+        {
+            auto re = 1.0 - x * x;
+            auto num = re * re + (x * A / q) * (x * A / q);
+            auto den = re * re + (x / (A * q)) * (x / (A * q));
+            return num / den;
+        };
+
+        auto poles = matchPoles(w0, A * q);
+        auto phi = phiAt(w0);
+
+        // khớp biên độ tại DC, Nyquist và tần số tâm
+        auto B0 = poles.A0;
+        auto B1 = poles.A1 * analogMagnitudeSquared(juce::MathConstants<double>::pi / w0);
+        auto B2 = (A * A * A * A * poles.magnitudeSquared(phi) - B0 * phi.p0 - B1 * phi.p1) / phi.p2;
+
+        auto sqrtB0 = std::sqrt(B0);
+        auto sqrtB1 = std::sqrt(B1);
+        auto W = 0.5 * (sqrtB0 + sqrtB1);
+
+        auto b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+        auto b1 = 0.5 * (sqrtB0 - sqrtB1);
+        auto b2 = -B2 / (4.0 * b0);
+
+        return { b0, b1, b2, poles.a1, poles.a2 };
+    }
+
+    RawBiquad normalise(double b0, double b1, double b2, double a0, double a1, double a2)
+    {
+        auto inv = 1.0 / a0;
+        return { b0 * inv, b1 * inv, b2 * inv, a1 * inv, a2 * inv };
+    }
+}
+
+double getButterworthSectionQ(int section, int order)
+{
+    jassert(order >= 2 && order <= 2 * MaxCutSections && order % 2 == 0);
+    return butterworthSectionQ(section, order);
+}
+
+double getPrewarp(float frequency, double sampleRate, const PrewarpTable* prewarpTable)
+{
+    if (prewarpTable != nullptr)
+    {
+        jassert(prewarpTable->getSampleRate() == sampleRate);
+        return prewarpTable->getG(frequency);
+    }
+
+    auto f = juce::jlimit(1.0, 0.49 * sampleRate, (double)frequency);
+    return std::tan(juce::MathConstants<double>::pi * f / sampleRate);
+}
+
+template<typename SampleType>
+CoefficientsArrayType<SampleType> makeBiquadStorage(int numSections)
+{
+    CoefficientsArrayType<SampleType> sections;
+    for (int i = 0; i < numSections; ++i)
+        sections.add(new juce::dsp::IIR::Coefficients<SampleType>(1, 0, 0, 1, 0, 0));
+
+    return sections;
+}
+
+template<typename SampleType>
+void writeBiquad(juce::dsp::IIR::Coefficients<SampleType>& target, const RawBiquad& coefficients)
+{
+    jassert(target.coefficients.size() == (int)coefficients.size());
+    auto* raw = target.getRawCoefficients();
+    for (size_t i = 0; i < coefficients.size(); ++i)
+        raw[i] = (SampleType)coefficients[i];
+}
+
+template<typename SampleType>
+void designHighPassCascade(CoefficientsArrayType<SampleType>& sections, float frequency, double sampleRate, int order, bool analogMatched,
+    const PrewarpTable* prewarpTable)
+{
+    jassert(order >= 2 && order <= 2 * MaxCutSections && order % 2 == 0);
+    jassert(sections.size() >= order / 2);
+
+    if (analogMatched)
+    {
+        for (int i = 0; i < order / 2; ++i)
+            writeBiquad(*sections.getUnchecked(i), matchedHighPassCoefficients(sampleRate, frequency, butterworthSectionQ(i, order)));
+        return;
+    }
+
+    auto n = getPrewarp(frequency, sampleRate, prewarpTable);
+    for (int i = 0; i < order / 2; ++i)
+        writeBiquad(*sections.getUnchecked(i), butterworthHighPassSection(n, butterworthSectionQ(i, order)));
+}
+
+template<typename SampleType>
+void designLowPassCascade(CoefficientsArrayType<SampleType>& sections, float frequency, double sampleRate, int order, bool analogMatched,
+    const PrewarpTable* prewarpTable)
+{
+    jassert(order >= 2 && order <= 2 * MaxCutSections && order % 2 == 0);
+    jassert(sections.size() >= order / 2);
+
+    if (analogMatched)
+    {
+        for (int i = 0; i < order / 2; ++i)
+            writeBiquad(*sections.getUnchecked(i), matchedLowPassCoefficients(sampleRate, frequency, butterworthSectionQ(i, order)));
+        return;
+    }
+
+    auto n = 1.0 / getPrewarp(frequency, sampleRate, prewarpTable);
+    for (int i = 0; i < order / 2; ++i)
+        writeBiquad(*sections.getUnchecked(i), butterworthLowPassSection(n, butterworthSectionQ(i, order)));
+}
+
+template CoefficientsArrayType<float> makeBiquadStorage<float>(int);
+template CoefficientsArrayType<double> makeBiquadStorage<double>(int);
+template void writeBiquad<float>(juce::dsp::IIR::Coefficients<float>&, const RawBiquad&);
+template void writeBiquad<double>(juce::dsp::IIR::Coefficients<double>&, const RawBiquad&);
+template void designHighPassCascade<float>(CoefficientsArrayType<float>&, float, double, int, bool, const PrewarpTable*);
+template void designHighPassCascade<double>(CoefficientsArrayType<double>&, float, double, int, bool, const PrewarpTable*);
+template void designLowPassCascade<float>(CoefficientsArrayType<float>&, float, double, int, bool, const PrewarpTable*);
+template void designLowPassCascade<double>(CoefficientsArrayType<double>&, float, double, int, bool, const PrewarpTable*);
+
+RawBiquad designPeakBiquad(double sampleRate, float frequency, float Q, float gainFactor, bool analogMatched,
+    const PrewarpTable* prewarpTable)
+{
+    if (analogMatched)
+    {
+        auto c = matchedPeakCoefficients(sampleRate, frequency, Q, gainFactor);
+        return normalise(c[0], c[1], c[2], 1.0, c[3], c[4]);
+    }
+
+    double sinOmega, cosOmega;
+    if (prewarpTable != nullptr)
+    {
+        // t = tan(w/2): sin w = 2t / (1 + t^2), cos w = (1 - t^2) / (1 + t^2)
+        auto t = getPrewarp(juce::jmax(frequency, 2.f), sampleRate, prewarpTable);
+        auto t2 = t * t;
+        sinOmega = 2.0 * t / (1.0 + t2);
+        cosOmega = (1.0 - t2) / (1.0 + t2);
+    }
+    else
+    {
+        auto omega = juce::MathConstants<double>::twoPi * juce::jmax((double)frequency, 2.0) / sampleRate;
+        sinOmega = std::sin(omega);
+        cosOmega = std::cos(omega);
+    }
+
+    // cùng công thức với IIR::Coefficients<float>::makePeakFilter
+    auto A = std::sqrt(juce::jmax(0.0, (double)gainFactor));
+    auto alpha = sinOmega / (Q * 2.0);
+    auto c2 = -2.0 * cosOmega;
+    auto alphaTimesA = alpha * A;
+    auto alphaOverA = alpha / A;
+
+    return normalise(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA, 1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+}
+
+RawBiquad designBandPassBiquad(double sampleRate, float frequency, float Q)
+{
+    // band-pass RBJ, đỉnh 0 dB
+    auto omega = juce::MathConstants<double>::twoPi * juce::jlimit(2.0, 0.49 * sampleRate, (double)frequency) / sampleRate;
+    auto alpha = std::sin(omega) / (Q * 2.0);
+
+    return normalise(alpha, 0.0, -alpha, 1.0 + alpha, -2.0 * std::cos(omega), 1.0 - alpha);
+}
+
+RawBiquad designLowShelfBiquad(double sampleRate, float frequency, float Q, float gainFactor)
+{
+    // cùng công thức với IIR::Coefficients<float>::makeLowShelf
+    auto A = std::sqrt(juce::jmax(0.0, (double)gainFactor));
+    auto aminus1 = A - 1.0;
+    auto aplus1 = A + 1.0;
+    auto omega = juce::MathConstants<double>::twoPi * juce::jlimit(2.0, 0.49 * sampleRate, (double)frequency) / sampleRate;
+    auto coso = std::cos(omega);
+    auto beta = std::sin(omega) * std::sqrt(A) / Q;
+    auto aminus1TimesCoso = aminus1 * coso;
+
+    return normalise(A * (aplus1 - aminus1TimesCoso + beta),
+        A * 2.0 * (aminus1 - aplus1 * coso),
+        A * (aplus1 - aminus1TimesCoso - beta),
+        aplus1 + aminus1TimesCoso + beta,
+        -2.0 * (aminus1 + aplus1 * coso),
+        aplus1 + aminus1TimesCoso - beta);
+}
+
+RawBiquad designHighShelfBiquad(double sampleRate, float frequency, float Q, float gainFactor)
+{
+    // cùng công thức với IIR::Coefficients<float>::makeHighShelf
+    auto A = std::sqrt(juce::jmax(0.0, (double)gainFactor));
+    auto aminus1 = A - 1.0;
+    auto aplus1 = A + 1.0;
+    auto omega = juce::MathConstants<double>::twoPi * juce::jlimit(2.0, 0.49 * sampleRate, (double)frequency) / sampleRate;
+    auto coso = std::cos(omega);
+    auto beta = std::sin(omega) * std::sqrt(A) / Q;
+    auto aminus1TimesCoso = aminus1 * coso;
+
+    return normalise(A * (aplus1 + aminus1TimesCoso + beta),
+        A * -2.0 * (aminus1 + aplus1 * coso),
+        A * (aplus1 + aminus1TimesCoso - beta),
+        aplus1 - aminus1TimesCoso + beta,
+        2.0 * (aminus1 - aplus1 * coso),
+        aplus1 - aminus1TimesCoso - beta);
+}
+
+RawBiquad designNotchBiquad(double sampleRate, float frequency, float Q)
+{
+    auto omega = juce::MathConstants<double>::twoPi * juce::jlimit(2.0, 0.49 * sampleRate, (double)frequency) / sampleRate;
+    auto alpha = std::sin(omega) / (Q * 2.0);
+    auto c2 = -2.0 * std::cos(omega);
+
+    return normalise(1.0, c2, 1.0, 1.0 + alpha, c2, 1.0 - alpha);
+}
+
+double getMagnitudeForFrequency(const RawBiquad& coefficients, double frequency, double sampleRate)
+{
+    auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    std::complex<double> z1 = std::polar(1.0, -w);
+    auto z2 = z1 * z1;
+
+    auto numerator = (double)coefficients[0] + (double)coefficients[1] * z1 + (double)coefficients[2] * z2;
+    auto denominator = 1.0 + (double)coefficients[3] * z1 + (double)coefficients[4] * z2;
+
+    return std::abs(numerator / denominator);
+}
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    FilterDesign.h
+
+    Analog-matched biquad designs (M. Vicanek, "Matched Second Order Digital
+    Filters", 2016). Poles are placed by impulse invariance and the zeros are
+    solved so the magnitude matches the analog prototype at DC, at the centre
+    frequency and at Nyquist, so there is no bilinear "cramping" near fs/2.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "CoefficientCache.h"
+
+template<typename SampleType>
+using CoefficientsArrayType = juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<SampleType>>;
+
+using CoefficientsArray = CoefficientsArrayType<float>;
+
+// hệ số thô đã chuẩn hoá a0 = 1: { b0, b1, b2, a1, a2 },
+// cùng layout với IIR::Coefficients<...>::coefficients của một biquad.
+// giữ double: đường xử lý 64-bit nhận đủ độ chính xác, đường float chỉ làm tròn khi ghi
+using RawBiquad = std::array<double, 5>;
+
+/*
+cộng vào input của mỗi tầng biquad TDF-II: với input im lặng trạng thái hội tụ về
+một hằng số nhỏ (normal) thay vì trôi vào vùng denormal, nên không phụ thuộc FTZ/DAZ
+của host / thread. -300 dB với float, double dùng giá trị nhỏ hơn để không chạm LSB.
+*/
+template<typename SampleType>
+constexpr SampleType antiDenormal = std::is_same_v<SampleType, double> ? (SampleType)1.0e-30 : (SampleType)1.0e-15;
+
+// thiết kế không cấp phát, dùng cho các bảng hệ số dựng lại trên audio thread
+// prewarpTable (tuỳ chọn, cùng sample rate): bản bilinear lấy tan(w/2) từ bảng thay vì sin/cos
+RawBiquad designPeakBiquad(double sampleRate, float frequency, float Q, float gainFactor, bool analogMatched,
+    const PrewarpTable* prewarpTable = nullptr);
+RawBiquad designBandPassBiquad(double sampleRate, float frequency, float Q);
+RawBiquad designLowShelfBiquad(double sampleRate, float frequency, float Q, float gainFactor);
+RawBiquad designHighShelfBiquad(double sampleRate, float frequency, float Q, float gainFactor);
+RawBiquad designNotchBiquad(double sampleRate, float frequency, float Q);
+
+// |H(e^jw)| của một biquad thô, dùng để vẽ đường cong phản hồi
+double getMagnitudeForFrequency(const RawBiquad& coefficients, double frequency, double sampleRate);
+
+// bộ cut dốc nhất 48 dB/oct = 4 tầng bậc 2
+constexpr int MaxCutSections = 4;
+
+// Q của tầng thứ section trong Butterworth bậc order (2, 4, 6, 8), lấy từ bảng tính sẵn
+double getButterworthSectionQ(int section, int order);
+
+// tan(pi f / fs) cho bilinear có prewarp (tần số bị kẹp dưới 0.49 fs), lấy từ bảng nếu có
+double getPrewarp(float frequency, double sampleRate, const PrewarpTable* prewarpTable = nullptr);
+
+// numSections tầng biquad đi thẳng, cấp 1 lần rồi các hàm design... ghi đè lên
+// (SampleType: float hoặc double, cùng kiểu với bộ lọc đang chạy)
+template<typename SampleType = float>
+CoefficientsArrayType<SampleType> makeBiquadStorage(int numSections);
+
+template<typename SampleType>
+void writeBiquad(juce::dsp::IIR::Coefficients<SampleType>& target, const RawBiquad& coefficients);
+
+/*
+Butterworth bậc chẵn (2, 4, 6, 8) ghép từ các tầng bậc 2, cùng kết quả với
+FilterDesign<float>::designIIR...HighOrderButterworthMethod nhưng Q các tầng
+lấy từ bảng tính sẵn, bilinear chỉ cần 1 lần tan() cho cả cascade và hệ số được
+ghi thẳng vào sections (ít nhất order / 2 phần tử): không cấp phát.
+analogMatched: mỗi tầng là high/low pass matched thay cho bilinear.
+prewarpTable (tuỳ chọn): lấy tan() từ bảng dùng chung, quét tần số chỉ còn tra bảng.
+*/
+template<typename SampleType>
+void designHighPassCascade(CoefficientsArrayType<SampleType>& sections, float frequency, double sampleRate, int order, bool analogMatched,
+    const PrewarpTable* prewarpTable = nullptr);
+template<typename SampleType>
+void designLowPassCascade(CoefficientsArrayType<SampleType>& sections, float frequency, double sampleRate, int order, bool analogMatched,
+    const PrewarpTable* prewarpTable = nullptr);
@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.cpp
+
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+namespace
+{
+    // BS.1770: hệ số gốc cho 48 kHz, dựng lại cho sample rate bất kỳ từ tần số / Q / gain tương đương
+    juce::dsp::IIR::Coefficients<float>::Ptr makePreFilter(double sampleRate)
+    {
+        constexpr double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+
+        auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        auto vh = std::pow(10.0, gainDb / 20.0);
+        auto vb = std::pow(vh, 0.4996667741545416);
+
+        return new juce::dsp::IIR::Coefficients<float>(
+            (float)(vh + vb * k / q + k * k), (float)(2.0 * (k * k - vh)), (float)(vh - vb * k / q + k * k),
+            (float)(1.0 + k / q + k * k), (float)(2.0 * (k * k - 1.0)), (float)(1.0 - k / q + k * k));
+    }
+
+    juce::dsp::IIR::Coefficients<float>::Ptr makeRlbFilter(double sampleRate)
+    {
+        constexpr double f0 = 38.13547087602444, q = 0.5003270373238773;
+
+        auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+
+        // tử số 1, -2, 1 không chuẩn hoá (đúng như bảng của BS.1770)
+        auto a0 = 1.0 + k / q + k * k;
+        return new juce::dsp::IIR::Coefficients<float>(
+            (float)a0, (float)(-2.0 * a0), (float)a0,
+            (float)a0, (float)(2.0 * (k * k - 1.0)), (float)(1.0 - k / q + k * k));
+    }
+}
+
+void LoudnessMeter::prepare(double sampleRate, int maximumBlockSize, int newNumChannels)
+{
+    numChannels = juce::jlimit(0, maxChannels, newNumChannels);
+    weighted.setSize(maxChannels, maximumBlockSize, false, true, true);
+
+    juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)maximumBlockSize, 1 };
+    auto preFilter = makePreFilter(sampleRate);
+    auto rlbFilter = makeRlbFilter(sampleRate);
+
+    for (int channel = 0; channel < maxChannels; ++channel) {
+        shelf[(size_t)channel].coefficients = preFilter;
+        highPass[(size_t)channel].coefficients = rlbFilter;
+        shelf[(size_t)channel].prepare(spec);
+        highPass[(size_t)channel].prepare(spec);
+    }
+
+    subBlockLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+
+    // sample rate càng cao càng ít cần nội suy: 4x dưới 96 kHz, 2x dưới 192 kHz
+    oversampling = sampleRate < 96000.0 ? 4 : (sampleRate < 192000.0 ? 2 : 1);
+
+    // sinc cửa sổ Blackman cắt ở Nyquist gốc, tách pha và đảo thứ tự để tích vô hướng đi xuôi
+    const auto numTaps = oversampling * tapsPerPhase;
+    std::vector<double> h((size_t)numTaps);
+    auto sum = 0.0;
+    for (int n = 0; n < numTaps; ++n) {
+        auto x = (n - (numTaps - 1) * 0.5) / oversampling;
+        auto sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+        auto phase = 2.0 * juce::MathConstants<double>::pi * n / (numTaps - 1);
+        h[(size_t)n] = sinc * (0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+        sum += h[(size_t)n];
+    }
+
+    interpolator.fill(0.f);
+    for (int p = 0; p < oversampling; ++p)
+        for (int j = 0; j < tapsPerPhase; ++j)
+            interpolator[(size_t)(p * tapsPerPhase + j)] = (float)(h[(size_t)(p + oversampling * (tapsPerPhase - 1 - j))] * oversampling / sum);
+
+    resetRequested = false;
+    reset();
+}
+
+void LoudnessMeter::reset()
+{
+    for (int channel = 0; channel < maxChannels; ++channel) {
+        shelf[(size_t)channel].reset();
+        highPass[(size_t)channel].reset();
+        history[(size_t)channel].fill(0.f);
+        historyIndices[(size_t)channel] = 0;
+    }
+
+    subBlockPosition = 0;
+    subBlockEnergy = 0.0;
+    subBlocks.fill(0.0);
+    subBlockIndex = numSubBlocks = 0;
+
+    blockCounts.fill(0);
+    blockEnergies.fill(0.0);
+
+    peak = 0.f;
+    publish();
+}
+
+template<typename SampleType>
+void LoudnessMeter::process(const juce::AudioBuffer<SampleType>& buffer)
+{
+    if (resetRequested.exchange(false))
+        reset();
+
+    const auto chunkSize = weighted.getNumSamples();
+    const auto channels = juce::jmin(numChannels, buffer.getNumChannels());
+    if (chunkSize <= 0)
+        return;
+
+    // host gửi block lớn hơn lúc prepare: đo từng đoạn vừa bộ đệm, không bỏ sample nào
+    for (int start = 0; start < buffer.getNumSamples(); start += chunkSize)
+        processChunk(buffer, start, juce::jmin(chunkSize, buffer.getNumSamples() - start), channels);
+}
+
+template<typename SampleType>
+void LoudnessMeter::processChunk(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples, int channels)
+{
+    juce::dsp::AudioBlock<float> block(weighted);
+
+    for (int channel = 0; channel < channels; ++channel) {
+        auto* source = buffer.getReadPointer(channel, startSample);
+        auto* destination = weighted.getWritePointer(channel);
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = (float)source[i];
+
+        // true peak trên tín hiệu gốc, loudness trên bản K-weighted (ghi đè tại chỗ)
+        measureTruePeak(destination, numSamples, channel);
+
+        auto channelBlock = block.getSingleChannelBlock((size_t)channel).getSubBlock(0, (size_t)numSamples);
+        juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+        shelf[(size_t)channel].process(context);
+        highPass[(size_t)channel].process(context);
+    }
+
+    // block của host không trùng biên sub-block 100 ms: cắt theo biên
+    for (int start = 0; start < numSamples;) {
+        auto num = juce::jmin(numSamples - start, subBlockLength - subBlockPosition);
+        addSamples(start, num, channels);
+        start += num;
+    }
+}
+
+void LoudnessMeter::processSilence(int numSamples)
+{
+    if (resetRequested.exchange(false))
+        reset();
+
+    while (numSamples > 0) {
+        auto num = juce::jmin(numSamples, subBlockLength - subBlockPosition);
+        numSamples -= num;
+
+        subBlockPosition += num;
+        if (subBlockPosition == subBlockLength)
+            finishSubBlock();
+    }
+}
+
+void LoudnessMeter::measureTruePeak(const float* samples, int numSamples, int channel)
+{
+    auto& recent = history[(size_t)channel];
+    auto index = historyIndices[(size_t)channel];
+    auto maxValue = peak;
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto x = samples[i];
+        recent[(size_t)index] = recent[(size_t)(index + tapsPerPhase)] = x;
+        index = (index + 1) % tapsPerPhase;
+
+        maxValue = juce::jmax(maxValue, std::abs(x));
+        if (oversampling == 1)
+            continue;
+
+        // [index, index + tapsPerPhase): tapsPerPhase sample gần nhất, cũ -> mới
+        const auto* window = recent.data() + index;
+        for (int p = 0; p < oversampling; ++p) {
+            const auto* taps = interpolator.data() + p * tapsPerPhase;
+            auto y = 0.f;
+            for (int j = 0; j < tapsPerPhase; ++j)
+                y += taps[j] * window[j];
+
+            maxValue = juce::jmax(maxValue, std::abs(y));
+        }
+    }
+
+    historyIndices[(size_t)channel] = index;
+    peak = maxValue;
+}
+
+void LoudnessMeter::addSamples(int start, int numSamples, int channels)
+{
+    for (int channel = 0; channel < channels; ++channel) {
+        const auto* samples = weighted.getReadPointer(channel, start);
+        auto sum = 0.f;
+        for (int i = 0; i < numSamples; ++i)
+            sum += samples[i] * samples[i];
+
+        subBlockEnergy += sum;
+    }
+
+    subBlockPosition += numSamples;
+    if (subBlockPosition == subBlockLength)
+        finishSubBlock();
+}
+
+void LoudnessMeter::finishSubBlock()
+{
+    subBlocks[(size_t)subBlockIndex] = subBlockEnergy / subBlockLength;
+    subBlockIndex = (subBlockIndex + 1) % shortTermSubBlocks;
+    numSubBlocks = juce::jmin(numSubBlocks + 1, shortTermSubBlocks);
+
+    subBlockEnergy = 0.0;
+    subBlockPosition = 0;
+
+    // block gating 400 ms chồng 75%: mỗi sub-block mới kết thúc một block
+    if (numSubBlocks >= momentarySubBlocks) {
+        auto meanSquare = 0.0;
+        for (int i = 1; i <= momentarySubBlocks; ++i)
+            meanSquare += subBlocks[(size_t)((subBlockIndex - i + shortTermSubBlocks) % shortTermSubBlocks)];
+        meanSquare /= momentarySubBlocks;
+
+        auto loudness = toLoudness(meanSquare);
+        if (loudness > absoluteGate) {
+            auto bin = juce::jlimit(0, histogramSize - 1, (int)((loudness - absoluteGate) * binsPerLU));
+            ++blockCounts[(size_t)bin];
+            blockEnergies[(size_t)bin] += meanSquare;
+        }
+    }
+
+    publish();
+}
+
+void LoudnessMeter::publish()
+{
+    auto getMean = [this](int count) {
+        auto sum = 0.0;
+        for (int i = 1; i <= count; ++i)
+            sum += subBlocks[(size_t)((subBlockIndex - i + shortTermSubBlocks) % shortTermSubBlocks)];
+        return sum / count;
+    };
+
+    momentary.store(numSubBlocks >= momentarySubBlocks ? toLoudness(getMean(momentarySubBlocks)) : -std::numeric_limits<float>::infinity(),
+        std::memory_order_relaxed);
+    shortTerm.store(numSubBlocks >= shortTermSubBlocks ? toLoudness(getMean(shortTermSubBlocks)) : -std::numeric_limits<float>::infinity(),
+        std::memory_order_relaxed);
+
+    // cổng tương đối = loudness của các block qua cổng tuyệt đối - 10 LU
+    juce::uint32 count = 0;
+    auto energy = 0.0;
+    for (int bin = 0; bin < histogramSize; ++bin) {
+        count += blockCounts[(size_t)bin];
+        energy += blockEnergies[(size_t)bin];
+    }
+
+    auto gated = -std::numeric_limits<float>::infinity();
+    if (count > 0) {
+        auto relativeGate = toLoudness(energy / count) - 10.f;
+        auto firstBin = juce::jlimit(0, histogramSize, (int)std::ceil((relativeGate - absoluteGate) * binsPerLU));
+
+        count = 0;
+        energy = 0.0;
+        for (int bin = firstBin; bin < histogramSize; ++bin) {
+            count += blockCounts[(size_t)bin];
+            energy += blockEnergies[(size_t)bin];
+        }
+
+        if (count > 0)
+            gated = toLoudness(energy / count);
+    }
+
+    integrated.store(gated, std::memory_order_relaxed);
+    truePeak.store(peak > 0.f ? 20.f * std::log10(peak) : -std::numeric_limits<float>::infinity(), std::memory_order_relaxed);
+}
+
+LoudnessMeter::Readings LoudnessMeter::getReadings() const
+{
+    return { momentary.load(std::memory_order_relaxed),
+             shortTerm.load(std::memory_order_relaxed),
+             integrated.load(std::memory_order_relaxed),
+             truePeak.load(std::memory_order_relaxed) };
+}
+
+double LoudnessMeter::getWeightingPower(double frequency, double sampleRate)
+{
+    auto magnitude = makePreFilter(sampleRate)->getMagnitudeForFrequency(frequency, sampleRate)
+        * makeRlbFilter(sampleRate)->getMagnitudeForFrequency(frequency, sampleRate);
+    return magnitude * magnitude;
+}
+
+float LoudnessMeter::toLoudness(double meanSquare)
+{
+    return meanSquare > 0.0 ? (float)(-0.691 + 10.0 * std::log10(meanSquare)) : -std::numeric_limits<float>::infinity();
+}
+
+template void LoudnessMeter::process<float>(const juce::AudioBuffer<float>&);
+template void LoudnessMeter::process<double>(const juce::AudioBuffer<double>&);
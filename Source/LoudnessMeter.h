@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+
+    EBU R128 / ITU-R BS.1770 output metering, run on the audio thread in
+    the same pass as the EQ:
+    - K-weighting (pre-filter shelf + RLB high-pass) through the same
+      BiquadFilter the EQ chain uses
+    - momentary (400 ms) and short-term (3 s) loudness from a ring of
+      100 ms sub-block energies
+    - integrated loudness with the absolute (-70 LUFS) and relative
+      (-10 LU) gates, from a fixed histogram of 400 ms block energies, so
+      an arbitrarily long measurement never allocates
+    - true peak through a polyphase interpolator (4x below 96 kHz, 2x
+      below 192 kHz)
+    Readings are published every 100 ms through atomics; the GUI only loads
+    them.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "BiquadFilter.h"
+
+struct LoudnessMeter
+{
+    // cổng tuyệt đối, cũng là đáy của histogram
+    static constexpr float absoluteGate = -70.f;
+
+    struct Readings
+    {
+        // LUFS, -inf khi chưa đủ dữ liệu / im lặng
+        float momentary, shortTerm, integrated;
+        // dBTP lớn nhất từ lần reset gần nhất
+        float truePeak;
+    };
+
+    // cấp bộ đệm + hệ số (không gọi từ audio thread), xoá mọi số đo
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+
+    // buffer sau xử lý, tối đa 2 kênh đầu được đo (trọng số 1 như BS.1770 cho L / R)
+    template<typename SampleType>
+    void process(const juce::AudioBuffer<SampleType>& buffer);
+
+    // block im lặng không chạy bộ lọc: chỉ đẩy đồng hồ sub-block với năng lượng 0
+    void processSilence(int numSamples);
+
+    // từ thread bất kỳ: audio thread xoá integrated + true peak ở block kế tiếp
+    void requestReset() { resetRequested = true; }
+
+    Readings getReadings() const;
+
+    // |H|^2 của K-weighting (pre-filter x RLB) tại frequency, không gọi từ audio thread
+    static double getWeightingPower(double frequency, double sampleRate);
+
+private:
+    static constexpr int maxChannels = 2;
+
+    // sub-block 100 ms: 4 cái cho momentary, 30 cái cho short-term
+    static constexpr int momentarySubBlocks = 4;
+    static constexpr int shortTermSubBlocks = 30;
+
+    // histogram 0.1 LU từ -70 tới +10 LUFS
+    static constexpr int binsPerLU = 10;
+    static constexpr int histogramSize = 80 * binsPerLU;
+
+    // bộ lọc nội suy true peak: mỗi pha tapsPerPhase hệ số
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int maxOversampling = 4;
+
+    int numChannels = 0;
+
+    std::array<BiquadFilter<float>, maxChannels> shelf, highPass;
+    juce::AudioBuffer<float> weighted;
+
+    int subBlockLength = 4410, subBlockPosition = 0;
+    double subBlockEnergy = 0.0;
+
+    std::array<double, shortTermSubBlocks> subBlocks{};
+    int subBlockIndex = 0, numSubBlocks = 0;
+
+    std::array<juce::uint32, histogramSize> blockCounts{};
+    std::array<double, histogramSize> blockEnergies{};
+
+    int oversampling = maxOversampling;
+    std::array<float, maxOversampling * tapsPerPhase> interpolator{};
+    // tapsPerPhase sample gần nhất, ghi 2 lần để đọc liền một đoạn
+    std::array<std::array<float, 2 * tapsPerPhase>, maxChannels> history{};
+    std::array<int, maxChannels> historyIndices{};
+    float peak = 0.f;
+
+    std::atomic<float> momentary{ 0.f }, shortTerm{ 0.f }, integrated{ 0.f }, truePeak{ 0.f };
+    std::atomic<bool> resetRequested{ false };
+
+    void reset();
+
+    // một đoạn của buffer, dài tối đa bằng bộ đệm weighted
+    template<typename SampleType>
+    void processChunk(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples, int channels);
+    void measureTruePeak(const float* samples, int numSamples, int channel);
+    void addSamples(int start, int numSamples, int channels);
+    void finishSubBlock();
+    void publish();
+
+    static float toLoudness(double meanSquare);
+};
@@ -0,0 +1,574 @@
+/*
+  ==============================================================================
+
+    MatchEq.cpp
+
+  ==============================================================================
+*/
+
+#include "MatchEq.h"
+#include "AnalyzerPipeline.h"
+
+void SpectrumCapture::reset(int numPoints)
+{
+    powerSum.assign((size_t)numPoints, 0.0);
+    numFrames = 0;
+}
+
+void SpectrumCapture::add(const std::vector<float>& magnitudes)
+{
+    jassert(magnitudes.size() == powerSum.size());
+
+    for (size_t i = 0; i < powerSum.size() && i < magnitudes.size(); ++i)
+        powerSum[i] += (double)magnitudes[i] * (double)magnitudes[i];
+
+    ++numFrames;
+}
+
+void SpectrumCapture::merge(const SpectrumCapture& other)
+{
+    if (powerSum.size() != other.powerSum.size())
+        return;
+
+    for (size_t i = 0; i < powerSum.size(); ++i)
+        powerSum[i] += other.powerSum[i];
+
+    numFrames += other.numFrames;
+}
+
+float SpectrumCapture::getAverageDecibels(int point) const
+{
+    if (numFrames == 0 || !juce::isPositiveAndBelow(point, (int)powerSum.size()))
+        return -std::numeric_limits<float>::infinity();
+
+    auto power = powerSum[(size_t)point] / numFrames;
+    return power > 0.0 ? (float)(10.0 * std::log10(power)) : -std::numeric_limits<float>::infinity();
+}
+
+//==============================================================================
+namespace
+{
+    // dưới mức này (dB) điểm lưới coi như không có tín hiệu, không dùng để khớp
+    constexpr float captureFloor = -90.f;
+
+    // làm mượt chênh lệch +-1/6 octave trên lưới, rồi chấm trên 1/4 số điểm
+    constexpr int fitStride = 4;
+
+    // log2 lowcut, log2 highcut, log2 peak freq, peak gain (dB), log2 Q
+    constexpr int numFitParameters = 5;
+    using FitVector = std::array<double, numFitParameters>;
+
+    const FitVector fitMinimum{ std::log2(20.0), std::log2(20.0), std::log2(20.0), -24.0, std::log2(0.1) };
+    const FitVector fitMaximum{ std::log2(20000.0), std::log2(20000.0), std::log2(20000.0), 24.0, std::log2(10.0) };
+
+    // cut: tắt (-1) hoặc slope 12..48 dB/oct, mọi tổ hợp của 2 bộ cut
+    constexpr int numCutChoices = 5;
+    constexpr int numStructures = numCutChoices * numCutChoices;
+
+    struct FitProblem
+    {
+        ChainSettings base;
+        double sampleRate = 48000.0;
+
+        // chênh lệch mục tiêu (dB, đã bỏ trung bình) và trọng số (tổng 1) trên các điểm chấm
+        std::vector<double> frequencies, target, weights;
+    };
+
+    ChainSettings makeSettings(const FitProblem& problem, const FitVector& x, int lowCutSlope, int highCutSlope)
+    {
+        auto settings = problem.base;
+
+        settings.lowCutBypassed = lowCutSlope < 0;
+        settings.highCutBypassed = highCutSlope < 0;
+        if (lowCutSlope >= 0)
+            settings.lowCutSlope = (Slope)lowCutSlope;
+        if (highCutSlope >= 0)
+            settings.highCutSlope = (Slope)highCutSlope;
+
+        settings.lowCutFreq = (float)std::exp2(x[0]);
+        settings.highCutFreq = (float)std::exp2(x[1]);
+        settings.peakFreq = (float)std::exp2(x[2]);
+        settings.peakGainInDecibels = (float)x[3];
+        settings.peakQuality = (float)std::exp2(x[4]);
+        settings.peakBypassed = false;
+
+        return settings;
+    }
+
+    // sai số bình phương trung bình (dB^2) của đáp ứng thật của chain so với mục tiêu
+    double getResponseError(const FitProblem& problem, CoefficientSnapshot& snapshot, const ChainSettings& settings)
+    {
+        snapshot.design(settings, problem.sampleRate, 0, nullptr, false);
+
+        auto error = 0.0;
+        for (size_t i = 0; i < problem.frequencies.size(); ++i) {
+            auto decibels = juce::Decibels::gainToDecibels(snapshot.getMagnitudeForFrequency(problem.frequencies[i]), -120.0);
+            auto difference = decibels - problem.target[i];
+            error += problem.weights[i] * difference * difference;
+        }
+
+        return error;
+    }
+}
+
+//==============================================================================
+struct MatchEq::State : juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<State>;
+
+    explicit State(MatchEq& matchEq) : owner(&matchEq) {}
+
+    // lưới của AnalyzerPipeline
+    const std::vector<float> gridFrequencies = AnalyzerPipeline::makeGridFrequencies();
+
+    // phổ của 2 target: live (message thread) chỉ thử lock, job file giữ lock lúc gộp
+    std::array<SpectrumCapture, NumTargets> captures;
+    mutable juce::SpinLock captureLock;
+
+    std::atomic<int> pendingFiles{ 0 };
+    // tăng mỗi lần clear() và khi MatchEq huỷ: job file của đời trước không gộp vào nữa
+    std::atomic<juce::uint32> generation{ 0 };
+
+    std::atomic<bool> fitting{ false }, fitCancelled{ false };
+    std::atomic<float> fitProgress{ 0.f }, fitError{ 0.f };
+
+    // bản tốt nhất của lần fit, đọc trong handleAsyncUpdate
+    ChainSettings fitResult;
+    bool fitResultReady = false;
+    juce::SpinLock resultLock;
+
+    void addCapture(Target target, const SpectrumCapture& capture)
+    {
+        const juce::SpinLock::ScopedLockType lock(captureLock);
+        captures[(size_t)target].merge(capture);
+    }
+
+    void finishFit(const ChainSettings* result)
+    {
+        {
+            const juce::SpinLock::ScopedLockType lock(resultLock);
+            fitResultReady = result != nullptr;
+            if (result != nullptr)
+                fitResult = *result;
+        }
+
+        fitting = false;
+
+        // MatchEq đã huỷ thì không còn ai nhận kết quả
+        const juce::ScopedLock sl(ownerLock);
+        if (owner != nullptr)
+            owner->triggerAsyncUpdate();
+    }
+
+    // ~MatchEq gọi trước khi huỷ AsyncUpdater, sau đó không job nào báo được nữa
+    void release()
+    {
+        {
+            const juce::ScopedLock sl(ownerLock);
+            owner = nullptr;
+        }
+
+        ++generation;
+        fitCancelled = true;
+    }
+
+private:
+    MatchEq* owner;
+    juce::CriticalSection ownerLock;
+};
+
+namespace
+{
+    // một pool cho mọi instance, giải phóng cùng instance cuối cùng: ~ThreadPool chờ các job
+    // đang chạy tới lần kiểm tra huỷ kế tiếp (không giữ tới lúc unload thư viện, lúc đó join thread không an toàn)
+    std::shared_ptr<juce::ThreadPool> getSharedPool()
+    {
+        static juce::CriticalSection lock;
+        static std::weak_ptr<juce::ThreadPool> shared;
+
+        const juce::ScopedLock sl(lock);
+
+        auto pool = shared.lock();
+        if (pool == nullptr) {
+            pool = std::make_shared<juce::ThreadPool>(juce::jmax(1, juce::SystemStats::getNumCpus() - 1));
+            shared = pool;
+        }
+
+        return pool;
+    }
+}
+
+//==============================================================================
+struct MatchEq::FileJob : juce::ThreadPoolJob
+{
+    FileJob(State::Ptr sharedState, const juce::File& fileToAnalyse, Target captureTarget, juce::uint32 captureGeneration)
+        : juce::ThreadPoolJob("Match EQ: " + fileToAnalyse.getFileName()),
+          owner(std::move(sharedState)), file(fileToAnalyse), target(captureTarget), generation(captureGeneration)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto capture = analyse();
+
+        // clear() trong lúc phân tích: bỏ kết quả
+        if (capture.getNumFrames() > 0 && !isCancelled())
+            owner->addCapture(target, capture);
+
+        --owner->pendingFiles;
+        return jobHasFinished;
+    }
+
+private:
+    State::Ptr owner;
+    juce::File file;
+    Target target;
+    juce::uint32 generation;
+
+    bool isCancelled() { return shouldExit() || generation != owner->generation.load(); }
+
+    SpectrumCapture analyse()
+    {
+        SpectrumCapture capture;
+        capture.reset((int)owner->gridFrequencies.size());
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+        if (reader == nullptr || reader->sampleRate <= 0)
+            return capture;
+
+        // cùng phân tích với analyzer (FFT, cửa sổ, số tầng theo sample rate của file)
+        constexpr auto order = AnalyzerPipeline::levelFFTOrder;
+        constexpr auto fftSize = 1 << order;
+        const auto numLevels = MultiResolutionSpectrum::getNumLevelsFor(reader->sampleRate);
+
+        juce::dsp::FFT fft(order);
+        juce::dsp::WindowingFunction<float> window((size_t)fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        std::vector<float> scratch((size_t)2 * fftSize, 0.f);
+
+        std::array<MultiResolutionSpectrum, 2> spectra;
+        std::array<std::vector<float>, 2> magnitudes;
+        std::vector<float> combined(owner->gridFrequencies.size(), 0.f);
+
+        for (size_t channel = 0; channel < spectra.size(); ++channel) {
+            spectra[channel].prepare(reader->sampleRate, order, numLevels, owner->gridFrequencies);
+            magnitudes[channel].assign(owner->gridFrequencies.size(), 0.f);
+        }
+
+        // mỗi đoạn fftSize một khung: tầng trên cùng không chồng lấn, tầng sâu chồng như lúc live.
+        // bỏ các khung đầu khi cửa sổ của tầng sâu nhất còn chứa 0
+        const auto warmUp = (juce::int64)fftSize << (numLevels - 1);
+        juce::AudioBuffer<float> buffer(2, fftSize);
+
+        // file mono: cả 2 kênh nhận cùng dữ liệu
+        for (juce::int64 position = 0; position + fftSize <= reader->lengthInSamples; position += fftSize) {
+            if (isCancelled())
+                break;
+
+            reader->read(&buffer, 0, fftSize, position, true, true);
+
+            for (int channel = 0; channel < 2; ++channel) {
+                spectra[(size_t)channel].push(buffer.getReadPointer(channel), fftSize);
+                spectra[(size_t)channel].analyse(fft, window, scratch, magnitudes[(size_t)channel]);
+            }
+
+            if (position + fftSize < warmUp)
+                continue;
+
+            for (size_t i = 0; i < combined.size(); ++i)
+                combined[i] = std::sqrt(0.5f * (magnitudes[0][i] * magnitudes[0][i] + magnitudes[1][i] * magnitudes[1][i]));
+
+            capture.add(combined);
+        }
+
+        return capture;
+    }
+};
+
+//==============================================================================
+struct MatchEq::FitJob : juce::ThreadPoolJob
+{
+    FitJob(State::Ptr sharedState, FitProblem fitProblem)
+        : juce::ThreadPoolJob("Match EQ fit"), owner(std::move(sharedState)), problem(std::move(fitProblem))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto found = solve();
+        owner->finishFit(found && !isCancelled() ? &best : nullptr);
+        return jobHasFinished;
+    }
+
+private:
+    State::Ptr owner;
+    FitProblem problem;
+    ChainSettings best;
+
+    bool isCancelled() { return shouldExit() || owner->fitCancelled.load(); }
+
+    bool solve()
+    {
+        // snapshot riêng của job, chỉ dùng để thiết kế + đo đáp ứng
+        CoefficientSnapshot snapshot;
+        auto bestError = std::numeric_limits<double>::max();
+
+        // điểm bắt đầu của peak: chỗ lệch nhiều nhất
+        size_t peakIndex = 0;
+        for (size_t i = 0; i < problem.target.size(); ++i)
+            if (problem.weights[i] > 0.0 && std::abs(problem.target[i]) > std::abs(problem.target[peakIndex]))
+                peakIndex = i;
+
+        const FitVector start{ std::log2(40.0), std::log2(15000.0),
+            std::log2(problem.frequencies.empty() ? 1000.0 : problem.frequencies[peakIndex]),
+            problem.target.empty() ? 0.0 : juce::jlimit(-24.0, 24.0, problem.target[peakIndex]),
+            0.0 };
+
+        // mỗi cấu hình cut (tắt / slope) một lần tìm theo toạ độ, bước chia đôi khi không còn cải thiện
+        for (int structure = 0; structure < numStructures; ++structure) {
+            const auto lowCutSlope = structure / numCutChoices - 1;
+            const auto highCutSlope = structure % numCutChoices - 1;
+
+            const std::array<bool, numFitParameters> free{ lowCutSlope >= 0, highCutSlope >= 0, true, true, true };
+            FitVector steps{ 1.0, 1.0, 1.0, 3.0, 1.0 };
+
+            auto x = start;
+            auto error = getResponseError(problem, snapshot, makeSettings(problem, x, lowCutSlope, highCutSlope));
+
+            for (int round = 0; round < 200 && steps[0] > 1.0 / 48.0; ++round) {
+                if (isCancelled())
+                    return false;
+
+                auto improved = false;
+                for (int d = 0; d < numFitParameters; ++d) {
+                    if (!free[(size_t)d])
+                        continue;
+
+                    for (auto direction : { 1.0, -1.0 }) {
+                        auto candidate = x;
+                        candidate[(size_t)d] = juce::jlimit(fitMinimum[(size_t)d], fitMaximum[(size_t)d],
+                            x[(size_t)d] + direction * steps[(size_t)d]);
+                        if (candidate[(size_t)d] == x[(size_t)d])
+                            continue;
+
+                        auto candidateError = getResponseError(problem, snapshot, makeSettings(problem, candidate, lowCutSlope, highCutSlope));
+                        if (candidateError < error) {
+                            x = candidate;
+                            error = candidateError;
+                            improved = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (!improved)
+                    for (auto& step : steps)
+                        step *= 0.5;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                best = makeSettings(problem, x, lowCutSlope, highCutSlope);
+                owner->fitError = (float)std::sqrt(error);
+            }
+
+            owner->fitProgress = float(structure + 1) / float(numStructures);
+        }
+
+        return bestError < std::numeric_limits<double>::max();
+    }
+};
+
+//==============================================================================
+MatchEq::MatchEq()
+    : state(new State(*this))
+{
+    for (auto& capture : state->captures)
+        capture.reset((int)state->gridFrequencies.size());
+}
+
+MatchEq::~MatchEq()
+{
+    // không chờ job của mình: job giữ State, thấy generation / fitCancelled đổi thì dừng ở lần kiểm tra kế tiếp.
+    // Instance cuối cùng thả pool dùng chung, ~ThreadPool chờ đúng lần kiểm tra đó
+    state->release();
+    cancelPendingUpdate();
+}
+
+juce::ThreadPool& MatchEq::getPool()
+{
+    if (pool == nullptr)
+        pool = getSharedPool();
+
+    return *pool;
+}
+
+void MatchEq::setLiveCapture(Target target, bool shouldCapture)
+{
+    if (shouldCapture)
+        liveTarget = (int)target;
+    else if (liveTarget == (int)target)
+        liveTarget = -1;
+}
+
+void MatchEq::addLiveFrame(const std::vector<float>& magnitudes)
+{
+    if (liveTarget < 0)
+        return;
+
+    // job file đang gộp: bỏ khung này, không chờ
+    const juce::SpinLock::ScopedTryLockType lock(state->captureLock);
+    if (lock.isLocked())
+        state->captures[(size_t)liveTarget].add(magnitudes);
+}
+
+void MatchEq::analyseFiles(const juce::Array<juce::File>& files, Target target)
+{
+    for (const auto& file : files) {
+        ++state->pendingFiles;
+        getPool().addJob(new FileJob(state, file, target, state->generation.load()), true);
+    }
+}
+
+int MatchEq::getNumPendingFiles() const
+{
+    return state->pendingFiles.load();
+}
+
+void MatchEq::clear()
+{
+    // job file của lần trước tự bỏ kết quả khi thấy generation đổi
+    ++state->generation;
+    liveTarget = -1;
+
+    const juce::SpinLock::ScopedLockType lock(state->captureLock);
+    for (auto& capture : state->captures)
+        capture.reset((int)state->gridFrequencies.size());
+}
+
+int MatchEq::getNumFrames(Target target) const
+{
+    const juce::SpinLock::ScopedLockType lock(state->captureLock);
+    return state->captures[(size_t)target].getNumFrames();
+}
+
+bool MatchEq::canFit() const
+{
+    return !isFitting() && !isLiveCapturing() && getNumPendingFiles() == 0
+        && getNumFrames(Source) > 0 && getNumFrames(Reference) > 0;
+}
+
+bool MatchEq::isFitting() const
+{
+    return state->fitting.load();
+}
+
+float MatchEq::getFitProgress() const
+{
+    return state->fitProgress.load();
+}
+
+float MatchEq::getFitError() const
+{
+    return state->fitError.load();
+}
+
+void MatchEq::startFit(const ChainSettings& current, double sampleRate, int channel)
+{
+    if (!canFit())
+        return;
+
+    std::array<SpectrumCapture, NumTargets> averages;
+    {
+        const juce::SpinLock::ScopedLockType lock(state->captureLock);
+        averages = state->captures;
+    }
+
+    FitProblem problem;
+    problem.base = current;
+    problem.sampleRate = sampleRate > 0 ? sampleRate : 48000.0;
+
+    // chênh lệch reference - source, chỉ ở điểm cả 2 phổ có tín hiệu và dưới Nyquist của chain
+    const auto& gridFrequencies = state->gridFrequencies;
+    const auto numPoints = (int)gridFrequencies.size();
+    std::vector<double> difference((size_t)numPoints, 0.0), valid((size_t)numPoints, 0.0);
+    for (int i = 0; i < numPoints; ++i) {
+        auto source = averages[Source].getAverageDecibels(i);
+        auto reference = averages[Reference].getAverageDecibels(i);
+
+        if (source > captureFloor && reference > captureFloor && gridFrequencies[(size_t)i] < problem.sampleRate * 0.45) {
+            difference[(size_t)i] = reference - source;
+            valid[(size_t)i] = 1.0;
+        }
+    }
+
+    // +-1/6 octave quanh mỗi điểm chấm (lưới ~38 điểm / octave)
+    const auto halfWidth = juce::roundToInt(numPoints / std::log2(1000.0) / 6.0);
+    auto weightSum = 0.0, mean = 0.0;
+
+    for (int i = 0; i < numPoints; i += fitStride) {
+        if (valid[(size_t)i] == 0.0)
+            continue;
+
+        auto sum = 0.0, count = 0.0;
+        for (int j = juce::jmax(0, i - halfWidth); j <= juce::jmin(numPoints - 1, i + halfWidth); ++j) {
+            sum += valid[(size_t)j] * difference[(size_t)j];
+            count += valid[(size_t)j];
+        }
+
+        problem.frequencies.push_back(gridFrequencies[(size_t)i]);
+        problem.target.push_back(sum / count);
+        problem.weights.push_back(1.0);
+
+        weightSum += 1.0;
+        mean += sum / count;
+    }
+
+    if (weightSum == 0.0)
+        return;
+
+    // chỉ khớp hình dạng: chênh lệch mức chung để cho auto gain / fader
+    mean /= weightSum;
+    for (size_t i = 0; i < problem.target.size(); ++i) {
+        problem.target[i] = juce::jlimit(-24.0, 24.0, problem.target[i] - mean);
+        problem.weights[i] /= weightSum;
+    }
+
+    fitChannel = channel;
+
+    state->fitCancelled = false;
+    state->fitProgress = 0.f;
+    state->fitError = 0.f;
+    state->fitting = true;
+
+    getPool().addJob(new FitJob(state, std::move(problem)), true);
+}
+
+void MatchEq::cancelFit()
+{
+    // không chờ: job dừng ở lần thử kế tiếp rồi tự báo xong
+    state->fitCancelled = true;
+}
+
+void MatchEq::handleAsyncUpdate()
+{
+    ChainSettings result;
+    auto ready = false;
+    {
+        const juce::SpinLock::ScopedLockType lock(state->resultLock);
+        std::swap(ready, state->fitResultReady);
+        result = state->fitResult;
+    }
+
+    if (ready && onFitFinished)
+        onFitFinished(result, fitChannel);
+}
+
+juce::String MatchEq::getFileWildcard()
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    return formats.getWildcardForAllFormats();
+}
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    MatchEq.h
+
+    Match EQ: long-term average spectra of a source and a reference on the
+    analyzer's log-frequency grid, captured either live from the pre-EQ tap
+    of the AnalyzerPipeline or offline from audio files (one pool job per
+    file, files analysed in parallel with the same multi-resolution
+    spectrum the analyzer uses). A background solver then fits the cut
+    filters (on / off, frequency, slope) and the peak (frequency, gain, Q)
+    of ChainSettings to the smoothed reference - source difference, scoring
+    each candidate on the real magnitude response of a CoefficientSnapshot.
+    All heavy work runs on one thread pool shared by every instance and
+    created on first use; the message thread only reads atomics and
+    receives the final result through an AsyncUpdater. The processor owns
+    the MatchEq, so captures survive closing the editor, and jobs share the
+    captures with it by reference count, so a MatchEq does not wait for
+    its own jobs. The exception is the last instance: it releases the
+    shared pool, and ~ThreadPool signals the running jobs and waits until
+    each one reaches its next cancellation check.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PluginProcessor.h"
+
+// phổ công suất trung bình dài hạn trên lưới log, mỗi khung cùng trọng số
+struct SpectrumCapture
+{
+    void reset(int numPoints);
+
+    // biên độ tuyến tính trên lưới (cùng số điểm)
+    void add(const std::vector<float>& magnitudes);
+    void merge(const SpectrumCapture& other);
+
+    int getNumFrames() const { return numFrames; }
+    int getNumPoints() const { return (int)powerSum.size(); }
+
+    // dB của công suất trung bình, -inf khi chưa có khung nào
+    float getAverageDecibels(int point) const;
+
+private:
+    std::vector<double> powerSum;
+    int numFrames = 0;
+};
+
+class MatchEq : private juce::AsyncUpdater
+{
+public:
+    enum Target { Source, Reference, NumTargets };
+
+    // lưới của AnalyzerPipeline
+    MatchEq();
+    ~MatchEq() override;
+
+    // live: khung phổ trước EQ mới nhất của analyzer đi vào target đang capture (message thread)
+    void setLiveCapture(Target target, bool shouldCapture);
+    bool isLiveCapturing() const { return liveTarget >= 0; }
+    bool isLiveCapturing(Target target) const { return liveTarget == (int)target; }
+    void addLiveFrame(const std::vector<float>& magnitudes);
+
+    // mỗi file một job trên pool, phổ của file cộng dồn vào target khi phân tích xong
+    void analyseFiles(const juce::Array<juce::File>& files, Target target);
+    int getNumPendingFiles() const;
+
+    // xoá cả 2 phổ, huỷ các file đang phân tích
+    void clear();
+    int getNumFrames(Target target) const;
+
+    // cả 2 phổ đã có dữ liệu và không có gì đang chạy
+    bool canFit() const;
+
+    /*
+    khớp cut + peak của current (các param khác giữ nguyên, kể cả band) với chênh lệch
+    reference - source, thiết kế theo sampleRate. Kết quả tới onFitFinished trên message thread
+    cùng channel của current (kênh lúc bắt đầu fit, không phải kênh đang chỉnh lúc xong).
+    */
+    void startFit(const ChainSettings& current, double sampleRate, int channel);
+    void cancelFit();
+    bool isFitting() const;
+
+    // 0..1 theo số cấu hình cut đã thử, sai số RMS (dB) của bản tốt nhất tới lúc này
+    float getFitProgress() const;
+    float getFitError() const;
+
+    std::function<void(const ChainSettings&, int channel)> onFitFinished;
+
+    // các định dạng đọc được, cho FileChooser
+    static juce::String getFileWildcard();
+
+private:
+    struct State;
+    struct FileJob;
+    struct FitJob;
+
+    // phổ, tiến độ và kết quả fit: job giữ tham chiếu tới State chứ không tới MatchEq
+    juce::ReferenceCountedObjectPtr<State> state;
+
+    // chỉ message thread
+    int liveTarget = -1;
+    int fitChannel = 0;
+
+    // pool dùng chung giữa các instance, lấy ở job đầu tiên
+    std::shared_ptr<juce::ThreadPool> pool;
+    juce::ThreadPool& getPool();
+
+    void handleAsyncUpdate() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MatchEq)
+};
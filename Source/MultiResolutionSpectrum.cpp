@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    MultiResolutionSpectrum.cpp
+
+  ==============================================================================
+*/
+
+#include "MultiResolutionSpectrum.h"
+
+namespace
+{
+    // sinc cửa sổ Blackman cắt ở fs / 4, tổng = 1 (DC không đổi)
+    template<int NumTaps>
+    std::array<float, NumTaps> makeHalfBand()
+    {
+        std::array<double, NumTaps> h{};
+        const auto centre = (NumTaps - 1) / 2;
+        auto sum = 0.0;
+
+        for (int n = 0; n < NumTaps; ++n) {
+            auto x = (n - centre) * 0.5;
+            auto sinc = n == centre ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            auto phase = 2.0 * juce::MathConstants<double>::pi * n / (NumTaps - 1);
+            auto blackman = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+
+            h[(size_t)n] = 0.5 * sinc * blackman;
+            sum += h[(size_t)n];
+        }
+
+        std::array<float, NumTaps> taps{};
+        for (int n = 0; n < NumTaps; ++n)
+            taps[(size_t)n] = (float)(h[(size_t)n] / sum);
+
+        return taps;
+    }
+}
+
+int MultiResolutionSpectrum::getNumLevelsFor(double sampleRate)
+{
+    return juce::jlimit(1, maxLevels, 1 + juce::roundToInt(std::log2(juce::jmax(1.0, sampleRate / 6000.0))));
+}
+
+void MultiResolutionSpectrum::prepare(double sampleRate, int fftOrder, int newNumLevels, const std::vector<float>& gridFrequencies)
+{
+    fftSize = 1 << fftOrder;
+    numLevels = juce::jlimit(1, maxLevels, newNumLevels);
+
+    const auto numBins = fftSize / 2;
+
+    for (auto& level : levels) {
+        level.ring.assign((size_t)fftSize, 0.f);
+        level.writeIndex = 0;
+        level.hasNewSamples = false;
+        level.history.fill(0.f);
+        level.historyIndex = 0;
+        level.evenSample = false;
+        level.bins.assign((size_t)numBins, {});
+        level.spectrum.assign((size_t)numBins, 0.f);
+    }
+
+    // tầng k dùng sạch tới fs_k / 4 (dưới đó alias của bộ half-band đã bị chặn):
+    // mỗi điểm lấy tầng sâu nhất còn phủ nó
+    auto getLevelFor = [this, sampleRate](float frequency) {
+        for (int level = numLevels - 1; level > 0; --level)
+            if (frequency <= sampleRate / std::ldexp(4.0, level))
+                return level;
+        return 0;
+    };
+
+    const auto numPoints = (int)gridFrequencies.size();
+    grid.resize((size_t)numPoints);
+
+    for (int i = 0; i < numPoints; ++i) {
+        auto frequency = gridFrequencies[(size_t)i];
+
+        // nửa khoảng (log) tới 2 điểm lân cận
+        auto lower = i > 0 ? std::sqrt(frequency * gridFrequencies[(size_t)i - 1]) : frequency;
+        auto upper = i + 1 < numPoints ? std::sqrt(frequency * gridFrequencies[(size_t)i + 1]) : frequency;
+
+        auto& point = grid[(size_t)i];
+        point.level = getLevelFor(frequency);
+
+        auto binWidth = sampleRate / std::ldexp((double)fftSize, point.level);
+        auto firstBin = (int)std::ceil(lower / binWidth);
+        auto lastBin = (int)std::floor(upper / binWidth);
+
+        point.interpolate = lastBin < firstBin;
+        if (point.interpolate) {
+            auto bin = juce::jlimit(0.0, (double)numBins - 1.001, frequency / binWidth);
+            point.firstBin = (int)bin;
+            point.lastBin = point.firstBin + 1;
+            point.fraction = (float)(bin - point.firstBin);
+        }
+        else {
+            point.firstBin = juce::jlimit(0, numBins - 1, firstBin);
+            point.lastBin = juce::jlimit(0, numBins - 1, lastBin);
+        }
+    }
+}
+
+void MultiResolutionSpectrum::push(const float* samples, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        pushSample(samples[i]);
+}
+
+void MultiResolutionSpectrum::pushSample(float sample)
+{
+    for (int index = 0; index < numLevels; ++index) {
+        auto& level = levels[(size_t)index];
+
+        level.ring[(size_t)level.writeIndex] = sample;
+        level.writeIndex = (level.writeIndex + 1) % fftSize;
+        level.hasNewSamples = true;
+
+        if (index + 1 == numLevels)
+            return;
+
+        level.history[(size_t)level.historyIndex] = sample;
+        level.historyIndex = (level.historyIndex + 1) % halfBandTaps;
+
+        // tầng sau chỉ nhận 1 trong 2 sample
+        level.evenSample = !level.evenSample;
+        if (level.evenSample)
+            return;
+
+        sample = decimate(level);
+    }
+}
+
+float MultiResolutionSpectrum::decimate(const Level& level)
+{
+    static const auto halfBand = makeHalfBand<halfBandTaps>();
+
+    constexpr int centre = (halfBandTaps - 1) / 2;
+
+    // historyIndex đang trỏ vào sample cũ nhất
+    auto sample = [&level](int n) { return level.history[(size_t)((level.historyIndex + n) % halfBandTaps)]; };
+
+    // chỉ tâm và các vị trí cách tâm một số lẻ khác 0: ~nửa số phép nhân
+    auto sum = halfBand[(size_t)centre] * sample(centre);
+    for (int n = (centre + 1) % 2; n < halfBandTaps; n += 2)
+        sum += halfBand[(size_t)n] * sample(n);
+
+    return sum;
+}
+
+void MultiResolutionSpectrum::analyse(const juce::dsp::FFT& fft, const juce::dsp::WindowingFunction<float>& window,
+    std::vector<float>& scratch, std::vector<float>& magnitudes)
+{
+    const auto numBins = fftSize / 2;
+
+    for (int index = 0; index < numLevels; ++index) {
+        auto& level = levels[(size_t)index];
+        if (!level.hasNewSamples)
+            continue;
+
+        level.hasNewSamples = false;
+
+        // trải ring theo thứ tự thời gian
+        std::fill(scratch.begin(), scratch.end(), 0.f);
+        auto tail = fftSize - level.writeIndex;
+        std::copy(level.ring.begin() + level.writeIndex, level.ring.end(), scratch.begin());
+        std::copy(level.ring.begin(), level.ring.begin() + level.writeIndex, scratch.begin() + tail);
+
+        window.multiplyWithWindowingTable(scratch.data(), (size_t)fftSize);
+
+        // giữ cả pha (tương quan theo dải của analyzer stereo), biên độ tự lấy abs như bản frequency-only
+        fft.performRealOnlyForwardTransform(scratch.data(), true);
+
+        for (int i = 0; i < numBins; ++i) {
+            std::complex<float> bin{ scratch[(size_t)i * 2] / float(numBins), scratch[(size_t)i * 2 + 1] / float(numBins) };
+            if (!std::isfinite(bin.real()) || !std::isfinite(bin.imag()))
+                bin = {};
+
+            level.bins[(size_t)i] = bin;
+            level.spectrum[(size_t)i] = std::abs(bin);
+        }
+    }
+
+    magnitudes.resize(grid.size());
+
+    for (size_t i = 0; i < grid.size(); ++i) {
+        const auto& point = grid[i];
+        const auto& spectrum = levels[(size_t)point.level].spectrum;
+
+        if (point.interpolate) {
+            auto a = spectrum[(size_t)point.firstBin];
+            auto b = spectrum[(size_t)point.lastBin];
+            magnitudes[i] = a + point.fraction * (b - a);
+        }
+        else {
+            // nhiều bin trên 1 điểm (đầu trên của mỗi tầng): giữ đỉnh
+            magnitudes[i] = *std::max_element(spectrum.begin() + point.firstBin, spectrum.begin() + point.lastBin + 1);
+        }
+    }
+}
+
+void MultiResolutionSpectrum::getCrossSpectrum(const MultiResolutionSpectrum& left, const MultiResolutionSpectrum& right,
+    std::vector<float>& cross, std::vector<float>& leftPower, std::vector<float>& rightPower)
+{
+    const auto numPoints = left.grid.size();
+    jassert(right.grid.size() == numPoints && right.numLevels == left.numLevels);
+
+    cross.resize(numPoints);
+    leftPower.resize(numPoints);
+    rightPower.resize(numPoints);
+
+    for (size_t i = 0; i < numPoints; ++i) {
+        const auto& point = left.grid[i];
+        const auto& l = left.levels[(size_t)point.level].bins;
+        const auto& r = right.levels[(size_t)point.level].bins;
+
+        // điểm nội suy: bin gần hơn, pha giữa 2 bin không nội suy tuyến tính được
+        auto first = point.interpolate ? point.firstBin + (point.fraction < 0.5f ? 0 : 1) : point.firstBin;
+        auto last = point.interpolate ? first : point.lastBin;
+
+        auto c = 0.f, pl = 0.f, pr = 0.f;
+        for (int bin = first; bin <= last; ++bin) {
+            c += (l[(size_t)bin] * std::conj(r[(size_t)bin])).real();
+            pl += std::norm(l[(size_t)bin]);
+            pr += std::norm(r[(size_t)bin]);
+        }
+
+        cross[i] = c;
+        leftPower[i] = pl;
+        rightPower[i] = pr;
+    }
+}
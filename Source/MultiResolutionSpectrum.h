@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    MultiResolutionSpectrum.h
+
+    Multi-resolution magnitude spectrum of one signal. Level k sees the
+    signal decimated by 2^k (cascaded half-band FIRs) and runs the same
+    small FFT, so each level doubles the frequency resolution of the one
+    above it for the same FFT cost. The levels are stitched onto one
+    log-frequency grid: every grid point reads the deepest (finest) level
+    whose clean band still covers it, through a bin range / interpolation
+    precomputed per point. At 48 kHz four 1024-point levels give the bass
+    resolution of a single 8192-point FFT for well under half the work,
+    and the top octaves keep a short window (sharp transients).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct MultiResolutionSpectrum
+{
+    static constexpr int maxLevels = 6;
+
+    // tầng sâu nhất có Nyquist quanh 3 kHz: 4 tầng ở 44.1 / 48 kHz, 5 ở 96 kHz
+    static int getNumLevelsFor(double sampleRate);
+
+    // gridFrequencies tăng dần (Hz); xoá trạng thái các tầng
+    void prepare(double sampleRate, int fftOrder, int numLevels, const std::vector<float>& gridFrequencies);
+
+    // sample ở tốc độ gốc, các tầng sau nhận bản đã decimate
+    void push(const float* samples, int numSamples);
+
+    /*
+    FFT các tầng có sample mới (fft / window cỡ 2^fftOrder dùng chung, scratch >= 2 * fftSize),
+    rồi ghép lên lưới: magnitudes[i] là biên độ tuyến tính tại gridFrequencies[i].
+    */
+    void analyse(const juce::dsp::FFT& fft, const juce::dsp::WindowingFunction<float>& window,
+        std::vector<float>& scratch, std::vector<float>& magnitudes);
+
+    /*
+    Re(L R*), |L|^2, |R|^2 trên từng điểm lưới, từ các bin phức của lần analyse gần nhất
+    (cùng ánh xạ bin với analyse). left / right phải được prepare giống nhau.
+    */
+    static void getCrossSpectrum(const MultiResolutionSpectrum& left, const MultiResolutionSpectrum& right,
+        std::vector<float>& cross, std::vector<float>& leftPower, std::vector<float>& rightPower);
+
+private:
+    // half-band FIR: hệ số cách tâm một số chẵn (trừ tâm) bằng 0
+    static constexpr int halfBandTaps = 31;
+
+    struct Level
+    {
+        // fftSize sample mới nhất ở tốc độ của tầng
+        std::vector<float> ring;
+        int writeIndex = 0;
+        bool hasNewSamples = false;
+
+        // lọc + bỏ 1 trong 2 sample sang tầng sau
+        std::array<float, halfBandTaps> history{};
+        int historyIndex = 0;
+        bool evenSample = false;
+
+        // bin phức (đã chuẩn hoá) và biên độ của chúng
+        std::vector<std::complex<float>> bins;
+        std::vector<float> spectrum;
+    };
+
+    // điểm lưới: lấy max trong [firstBin, lastBin] của tầng, hoặc nội suy khi khoảng hẹp hơn 1 bin
+    struct GridPoint
+    {
+        int level = 0, firstBin = 0, lastBin = 0;
+        float fraction = 0.f;
+        bool interpolate = true;
+    };
+
+    int fftSize = 1024, numLevels = 1;
+    std::array<Level, maxLevels> levels;
+    std::vector<GridPoint> grid;
+
+    void pushSample(float sample);
+    static float decimate(const Level& level);
+};
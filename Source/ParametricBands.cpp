@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    ParametricBands.cpp
+
+  ==============================================================================
+*/
+
+#include "ParametricBands.h"
+
+juce::String getBandParameterID(int band, const juce::String& name)
+{
+    juce::String str;
+    str << "Band" << (band + 1) << " " << name;
+    return str;
+}
+
+juce::StringArray getBandTypeNames()
+{
+    return { "Bell", "Low Shelf", "High Shelf", "Notch", "Band Pass", "Tilt" };
+}
+
+RawBiquad makeBandFilter(const BandSettings& band, double sampleRate, bool analogMatched)
+{
+    auto gainFactor = juce::Decibels::decibelsToGain(band.gainInDecibels);
+
+    switch (band.type) {
+    case BandType::LowShelf:
+        return designLowShelfBiquad(sampleRate, band.freq, band.quality, gainFactor);
+    case BandType::HighShelf:
+        return designHighShelfBiquad(sampleRate, band.freq, band.quality, gainFactor);
+    case BandType::Notch:
+        return designNotchBiquad(sampleRate, band.freq, band.quality);
+    case BandType::BandPass:
+        return designBandPassBiquad(sampleRate, band.freq, band.quality);
+    case BandType::Tilt: {
+        // high shelf +gain rồi hạ cả dải xuống một nửa: xoay quanh freq, -g/2 .. +g/2
+        auto coefficients = designHighShelfBiquad(sampleRate, band.freq, band.quality, gainFactor);
+        auto compensation = 1.f / std::sqrt(gainFactor);
+        coefficients[0] *= compensation;
+        coefficients[1] *= compensation;
+        coefficients[2] *= compensation;
+        return coefficients;
+    }
+    case BandType::Bell:
+    default:
+        return designPeakBiquad(sampleRate, band.freq, band.quality, gainFactor, analogMatched);
+    }
+}
+
+ParametricBandsCoefficients makeParametricBands(const BandArraySettings& bands, double sampleRate, bool analogMatched)
+{
+    ParametricBandsCoefficients result;
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        result.active[i] = bands[i].enabled;
+        if (bands[i].enabled)
+            result.coefficients[i] = makeBandFilter(bands[i], sampleRate, analogMatched);
+    }
+
+    return result;
+}
+
+//==============================================================================
+template<typename SampleType>
+void ParametricBands<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels == 1);
+
+    outputGain.prepare(spec.sampleRate);
+    reset();
+}
+
+template<typename SampleType>
+void ParametricBands<SampleType>::reset()
+{
+    for (auto& s : state)
+        s = { 0, 0 };
+
+    outputGain.reset();
+}
+
+template<typename SampleType>
+void ParametricBands<SampleType>::setCoefficients(const ParametricBandsCoefficients& newCoefficients)
+{
+    numActive = 0;
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        // band vừa được bật lại: bỏ trạng thái cũ để không bị click
+        if (newCoefficients.active[i] && !bands.active[i])
+            state[i] = { 0, 0 };
+
+        if (newCoefficients.active[i])
+            activeBands[numActive++] = i;
+    }
+
+    bands = newCoefficients;
+}
+
+template<typename SampleType>
+void ParametricBands<SampleType>::processSamples(SampleType* samples, int numSamples)
+{
+    processWith(samples, numSamples, WriteInPlace{ samples });
+}
+
+template<typename SampleType>
+void ParametricBands<SampleType>::processSamplesDecodingMidSide(SampleType* mid, SampleType* side, int numSamples)
+{
+    processWith(mid, numSamples, WriteMidSide{ mid, side });
+}
+
+template<typename SampleType>
+template<typename Write>
+void ParametricBands<SampleType>::processWith(SampleType* samples, int numSamples, const Write& write)
+{
+    // mỗi số lượng band active có một kernel riêng, vòng lặp trong được unroll hoàn toàn
+    switch (numActive) {
+    case 0: processGain(samples, numSamples, write); break;
+    case 1: processCascade<1>(samples, numSamples, write); break;
+    case 2: processCascade<2>(samples, numSamples, write); break;
+    case 3: processCascade<3>(samples, numSamples, write); break;
+    case 4: processCascade<4>(samples, numSamples, write); break;
+    case 5: processCascade<5>(samples, numSamples, write); break;
+    case 6: processCascade<6>(samples, numSamples, write); break;
+    case 7: processCascade<7>(samples, numSamples, write); break;
+    case 8: processCascade<8>(samples, numSamples, write); break;
+    default: jassertfalse; break;
+    }
+
+    outputGain.settle();
+}
+
+template<typename SampleType>
+template<typename Write>
+void ParametricBands<SampleType>::processGain(SampleType* samples, int numSamples, const Write& write)
+{
+    // không band nào bật: chỉ còn gain bù, 1 thì khỏi đụng buffer (trừ khi còn phải decode)
+    if (outputGain.isUnity()) {
+        if constexpr (!Write::inPlace)
+            for (int i = 0; i < numSamples; ++i)
+                write(i, samples[i]);
+
+        return;
+    }
+
+    auto gain = outputGain.current;
+    const auto target = outputGain.target, coefficient = outputGain.coefficient;
+
+    for (int i = 0; i < numSamples; ++i) {
+        gain += (target - gain) * coefficient;
+        write(i, samples[i] * gain);
+    }
+
+    outputGain.current = gain;
+}
+
+template<typename SampleType>
+template<int NumSections, typename Write>
+void ParametricBands<SampleType>::processCascade(SampleType* samples, int numSamples, const Write& write)
+{
+    static_assert(NumSections > 0 && NumSections <= MaxParametricBands, "invalid cascade length");
+
+    // nạp hệ số + trạng thái vào biến cục bộ để compiler giữ trong thanh ghi
+    SampleType b0[NumSections], b1[NumSections], b2[NumSections], a1[NumSections], a2[NumSections];
+    SampleType s1[NumSections], s2[NumSections];
+
+    for (int k = 0; k < NumSections; ++k) {
+        const auto& c = bands.coefficients[activeBands[k]];
+        b0[k] = (SampleType)c[0];
+        b1[k] = (SampleType)c[1];
+        b2[k] = (SampleType)c[2];
+        a1[k] = (SampleType)c[3];
+        a2[k] = (SampleType)c[4];
+
+        s1[k] = state[activeBands[k]][0];
+        s2[k] = state[activeBands[k]][1];
+    }
+
+    auto processSections = [&](SampleType x) {
+        for (int k = 0; k < NumSections; ++k) {
+            // trạng thái không bao giờ trôi vào vùng denormal (xem antiDenormal)
+            x += antiDenormal<SampleType>;
+            auto y = b0[k] * x + s1[k];
+            s1[k] = b1[k] * x - a1[k] * y + s2[k];
+            s2[k] = b2[k] * x - a2[k] * y;
+            x = y;
+        }
+        return x;
+    };
+
+    if (outputGain.isUnity()) {
+        for (int i = 0; i < numSamples; ++i)
+            write(i, processSections(samples[i]));
+    }
+    else {
+        // gain bù nhân ngay khi ghi ra, gain + target giữ trong thanh ghi như hệ số
+        auto gain = outputGain.current;
+        const auto target = outputGain.target, coefficient = outputGain.coefficient;
+
+        for (int i = 0; i < numSamples; ++i) {
+            gain += (target - gain) * coefficient;
+            write(i, processSections(samples[i]) * gain);
+        }
+
+        outputGain.current = gain;
+    }
+
+    for (int k = 0; k < NumSections; ++k) {
+        state[activeBands[k]][0] = s1[k];
+        state[activeBands[k]][1] = s2[k];
+    }
+}
+
+template struct ParametricBands<float>;
+template struct ParametricBands<double>;
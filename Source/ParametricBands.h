@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    ParametricBands.h
+
+    Fixed-capacity array of user bands (bell, shelves, notch, band-pass, tilt).
+    Every band type reduces to one biquad, so only the enabled bands are packed
+    into a cascade and the block is run through a kernel specialised on the
+    number of active sections. Disabled bands cost nothing, unlike a chain of
+    bypassed ProcessorChain slots.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "FilterDesign.h"
+
+constexpr int MaxParametricBands = 8;
+
+enum BandType {
+    Bell,
+    LowShelf,
+    HighShelf,
+    Notch,
+    BandPass,
+    Tilt
+};
+
+struct BandSettings {
+    bool enabled{ false };
+    BandType type{ BandType::Bell };
+    float freq{ 1000.f }, gainInDecibels{ 0 }, quality{ 1.f };
+};
+
+using BandArraySettings = std::array<BandSettings, MaxParametricBands>;
+
+// "Band3 Freq", ... (band đánh số từ 0)
+juce::String getBandParameterID(int band, const juce::String& name);
+
+juce::StringArray getBandTypeNames();
+
+RawBiquad makeBandFilter(const BandSettings& band, double sampleRate, bool analogMatched);
+
+// hệ số của cả mảng band, thiết kế 1 lần rồi nạp cho mọi kênh
+struct ParametricBandsCoefficients {
+    std::array<RawBiquad, MaxParametricBands> coefficients{};
+    std::array<bool, MaxParametricBands> active{};
+};
+
+ParametricBandsCoefficients makeParametricBands(const BandArraySettings& bands, double sampleRate, bool analogMatched);
+
+/*
+gain bù ở output của tầng cuối (auto gain): one-pole ~50 ms tới target, nhân ngay trong
+vòng lặp của tầng đó nên không tốn thêm lượt đi qua buffer. Target 1 và đã tới nơi
+thì tầng bỏ hẳn phép nhân.
+*/
+template<typename SampleType>
+struct SmoothedOutputGain
+{
+    void prepare(double sampleRate)
+    {
+        coefficient = (SampleType)(1.0 - std::exp(-1.0 / (0.05 * sampleRate)));
+    }
+
+    // nhảy thẳng tới target (reset chain, vừa prepare)
+    void reset() { current = target; }
+
+    void setTarget(SampleType newTarget) { target = newTarget; }
+
+    bool isUnity() const { return current == (SampleType)1 && target == (SampleType)1; }
+
+    // vòng lặp theo block tự giữ gain trong thanh ghi rồi gọi ở cuối:
+    // one-pole không bao giờ tới đúng target, đủ gần thì chốt
+    void settle()
+    {
+        if (std::abs(target - current) < (SampleType)1.0e-6)
+            current = target;
+    }
+
+    SampleType current = 1, target = 1;
+    SampleType coefficient = (SampleType)0.0005;
+};
+
+// processor kiểu juce::dsp (prepare / process / reset) để nằm được trong ProcessorChain,
+// SampleType: float hoặc double (hệ số luôn thiết kế ở double, làm tròn khi nạp vào kernel)
+template<typename SampleType>
+struct ParametricBands
+{
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void setCoefficients(const ParametricBandsCoefficients& newCoefficients);
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context)
+    {
+        auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+
+        jassert(outputBlock.getNumChannels() == 1);
+
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom(inputBlock);
+
+        if (context.isBypassed)
+            return;
+
+        processSamples(outputBlock.getChannelPointer(0), (int)outputBlock.getNumSamples());
+    }
+
+    void processSamples(SampleType* samples, int numSamples);
+
+    // tầng cuối của chain mid khi Mid/Side: side đã là output của chain side,
+    // decode L = M + S, R = M - S ngay lúc ghi ra (cùng chỗ nhân gain bù), không có lượt decode riêng
+    void processSamplesDecodingMidSide(SampleType* mid, SampleType* side, int numSamples);
+
+    // tầng cuối của chain biquad: gain auto gain được nhân trong cùng vòng lặp
+    void setOutputGain(SampleType gain) { outputGain.setTarget(gain); }
+
+private:
+    ParametricBandsCoefficients bands;
+
+    // trạng thái TDF-II giữ theo chỉ số band, không theo vị trí trong cascade
+    std::array<std::array<SampleType, 2>, MaxParametricBands> state{};
+
+    // các band đang bật, gom liền nhau
+    std::array<int, MaxParametricBands> activeBands{};
+    int numActive = 0;
+
+    SmoothedOutputGain<SampleType> outputGain;
+
+    // cách ghi output của kernel: tại chỗ, hoặc decode Mid/Side vào 2 kênh
+    struct WriteInPlace
+    {
+        static constexpr bool inPlace = true;
+        SampleType* samples;
+        void operator()(int i, SampleType y) const { samples[i] = y; }
+    };
+
+    struct WriteMidSide
+    {
+        static constexpr bool inPlace = false;
+        SampleType *mid, *side;
+        void operator()(int i, SampleType y) const
+        {
+            auto s = side[i];
+            mid[i] = y + s;
+            side[i] = y - s;
+        }
+    };
+
+    template<typename Write>
+    void processWith(SampleType* samples, int numSamples, const Write& write);
+    template<int NumSections, typename Write>
+    void processCascade(SampleType* samples, int numSamples, const Write& write);
+    template<typename Write>
+    void processGain(SampleType* samples, int numSamples, const Write& write);
+};
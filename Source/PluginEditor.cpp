@@ -221,9 +221,7 @@ juce::String RotarySliderWithLabels::getDisplayString() const{
 }
 
 //==============================================================================
-ResponseCurveComponent::ResponseCurveComponent(AudioPluginBetaAudioProcessor& p) : audioProcessor(p), 
-leftPathProducer(audioProcessor.leftChannelFifo),
-rightPathProducer(audioProcessor.rightChannelFifo)
+ResponseCurveComponent::ResponseCurveComponent(AudioPluginBetaAudioProcessor& p) : audioProcessor(p)
 {
     const auto& params = audioProcessor.getParameters();
     for (auto param : params) {
@@ -232,8 +230,12 @@ rightPathProducer(audioProcessor.rightChannelFifo)
 
     updateChain();
 
+    // analyzer tắt sẵn trong state thì không cấp gì cả
+    shouldShowFFTAnalysis = audioProcessor.apvts.getRawParameterValue("Analyzer Enabled")->load() > 0.5f;
+    updateAnalyzerStorage();
+
     // 
-    startTimerHz(60);
+    startTimerHz(analyzerFrameRate);
 }
 
 ResponseCurveComponent::~ResponseCurveComponent() {
@@ -241,152 +243,200 @@ ResponseCurveComponent::~ResponseCurveComponent() {
     for (auto param : params) {
         param->removeListener(this);
     }
+
+    // đóng editor: processor giải phóng fifo analyzer, không còn ai publish export
+    audioProcessor.getAnalyzerExport().close();
+    analyzerPipeline.reset();
+    audioProcessor.releaseAnalyzer(analyzerFifos);
 }
 
-void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue) {
-    parameterChanged.set(true);
+void ResponseCurveComponent::updateAnalyzerStorage() {
+    if (shouldShowFFTAnalysis) {
+        if (analyzerFifos == nullptr) {
+            analyzerFifos = audioProcessor.acquireAnalyzer();
+            analyzerPipeline = std::make_unique<AnalyzerPipeline>(*analyzerFifos);
+            updatePreAnalysis();
+            analyzerPipeline->setStereoAnalysisEnabled(showStereoMeters);
+        }
+
+        if (showSpectrogram && spectrogram == nullptr)
+            spectrogram = std::make_unique<Spectrogram>(AnalyzerPipeline::gridSize, spectrogramSeconds * analyzerFrameRate);
+        else if (!showSpectrogram)
+            spectrogram.reset();
+
+        return;
+    }
+
+    // pipeline trỏ vào fifo: huỷ trước khi nhả fifo
+    spectrogram.reset();
+    analyzerPipeline.reset();
+    audioProcessor.releaseAnalyzer(analyzerFifos);
 }
 
-void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate) {
-    juce::AudioBuffer<float> tempIncomingBuffer;
-        
-    while (leftChannelFifo->getNumCompleteBuffersAvailable() > 0) {
-        if (leftChannelFifo->getAudioBuffer(tempIncomingBuffer)) {
-            auto size = tempIncomingBuffer.getNumSamples();
+void ResponseCurveComponent::setPreTraceVisible(bool visible) {
+    showPreTrace = visible;
+    updatePreAnalysis();
+}
+
+void ResponseCurveComponent::setDifferenceTraceVisible(bool visible) {
+    showDifferenceTrace = visible;
+    updatePreAnalysis();
+}
 
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0),
-                monoBuffer.getReadPointer(0, size),
-                monoBuffer.getNumSamples() - size);
+void ResponseCurveComponent::setMatchCapture(MatchEq::Target target, bool shouldCapture) {
+    getMatchEq().setLiveCapture(target, shouldCapture);
+    updatePreAnalysis();
+}
 
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-                tempIncomingBuffer.getReadPointer(0, 0),
-                size);
+void ResponseCurveComponent::updatePreAnalysis() {
+    if (analyzerPipeline != nullptr)
+        analyzerPipeline->setPreAnalysisEnabled(showPreTrace || showDifferenceTrace || getMatchEq().isLiveCapturing());
+}
 
-            leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
+void ResponseCurveComponent::setSpectrogramVisible(bool visible) {
+    showSpectrogram = visible;
+    updateAnalyzerStorage();
+}
 
-        }
-    }
+void ResponseCurveComponent::setStereoMetersVisible(bool visible) {
+    showStereoMeters = visible;
+    if (analyzerPipeline != nullptr)
+        analyzerPipeline->setStereoAnalysisEnabled(showStereoMeters);
+}
 
-    // if there are FFT data buffers to pull
-    //      if we can pull a buffer
-    //          generate a path
-    // const auto fftBounds = getAnalysisArea().toFloat();
-    const auto fftSize = leftChannelFFTDataGenerator.getFFTSize();
+void ResponseCurveComponent::publishAnalyzerExport(double sampleRate) {
+    auto& analyzerExport = audioProcessor.getAnalyzerExport();
+    if (!audioProcessor.isAnalyzerExportEnabled())
+        return;
 
-    const auto binWidth = sampleRate / (double)fftSize;
+    // lưới của pipeline (dựng 1 lần), open() chỉ tạo lại segment khi sample rate đổi
+    if (!analyzerExport.open(analyzerPipeline->getGridFrequencies(), sampleRate))
+        return;
 
-    while (leftChannelFFTDataGenerator.getNumAvailableFFTDataBlocks() > 0) {
-        std::vector<float> fftData;
-        if (leftChannelFFTDataGenerator.getFFTData(fftData)) {
-            pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -48.f);
-        }
+    AnalyzerExport::Levels levels;
+
+    if (audioProcessor.isMeteringEnabled()) {
+        auto readings = audioProcessor.getLoudnessReadings();
+        levels.hasLoudness = true;
+        levels.momentary = readings.momentary;
+        levels.shortTerm = readings.shortTerm;
+        levels.integrated = readings.integrated;
+        levels.truePeak = readings.truePeak;
     }
 
-    /*
-    while there are paths that can be pulled
-        pull as many as we can
-            display the most recent path
-    */
-    while (pathProducer.getNumPathsAvailable()) {
-        pathProducer.getPath(leftChannelFFTPath);
+    if (analyzerPipeline->isStereoAnalysisEnabled()) {
+        levels.hasCorrelation = true;
+        levels.correlation = analyzerPipeline->getStereoAnalysis().getCorrelation();
     }
+
+    // phổ trước EQ chỉ mới khi tap trước EQ đang được phân tích
+    const auto* pre = analyzerPipeline->isPreAnalysisEnabled() ? &analyzerPipeline->getInputSpectrum() : nullptr;
+    analyzerExport.publish(analyzerPipeline->getSpectrum(), pre, levels);
+}
+
+void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue) {
+    parameterChanged.set(true);
 }
 
 void ResponseCurveComponent::timerCallback() {
       
-    if (shouldShowFFTAnalysis) {
+    if (shouldShowFFTAnalysis && analyzerPipeline != nullptr) {
         auto fftBounds = getAnalysisArea().toFloat();
         auto sampleRate = audioProcessor.getSampleRate();
 
-        leftPathProducer.process(fftBounds, sampleRate);
-        rightPathProducer.process(fftBounds, sampleRate);
+        // mỗi lần phân tích ghi đúng 1 hàng vào waterfall và 1 khung vào match EQ
+        if (analyzerPipeline->process(fftBounds, sampleRate)) {
+            if (spectrogram != nullptr)
+                spectrogram->pushFrame(analyzerPipeline->getSpectrum());
+
+            auto& matchEq = getMatchEq();
+            if (matchEq.isLiveCapturing())
+                matchEq.addLiveFrame(analyzerPipeline->getInputSpectrum());
+
+            publishAnalyzerExport(sampleRate);
+        }
     }
 
+    // export hoặc analyzer tắt: gỡ segment, reader thấy active = 0 thay vì khung đứng yên
+    if (analyzerPipeline == nullptr || !audioProcessor.isAnalyzerExportEnabled())
+        audioProcessor.getAnalyzerExport().close();
+
     // nếu atomic là true thì set thành false và trả về true
     if (parameterChanged.compareAndSetBool(false, true)) {
-        // update the mono chain
+        // audio thread thiết kế + publish ở block sau, trong lúc chờ thì vẽ bản preview
         updateChain();
         // signal a repaint
         // repaint();
 
     }
+    else {
+        // sample rate đổi hoặc preset được nạp: audio thread đã publish bản mới
+        refreshSnapshots();
+    }
 
     repaint();
 }
 
 void ResponseCurveComponent::updateChain() {
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
+    auto& apvts = audioProcessor.apvts;
+    previewSettings[0] = getChainSettings(apvts);
+    previewSettings[1] = previewSettings[0].stereoMode == StereoMode::Linked
+        ? previewSettings[0]
+        : getChainSettings(apvts, getChannelParameterPrefix(1));
+
+    usingPreview = true;
+    refreshSnapshots();
+}
 
-    monoChain.setBypassed<ChainPositions::lowCut>(chainSettings.lowCutBypassed);
-    monoChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-    monoChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+void ResponseCurveComponent::refreshSnapshots() {
+    // GUI không publish gì: chỉ audio thread thiết kế snapshot cho chain
+    snapshot = audioProcessor.getCoefficientSnapshot(0);
+    secondChannelSnapshot = audioProcessor.getCoefficientSnapshot(1);
 
-    // kết nối coefficients của peak khi update chain và vẽ lại trên đường thẳng phản hồi 
-    auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficents(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    auto sampleRate = audioProcessor.getSampleRate();
+    auto doublePrecision = audioProcessor.isUsingDoublePrecision();
 
-    // kết nối coefficients của cut filter khi update chain và vẽ lại trên đường thẳng phản hồi
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
+    if (usingPreview && sampleRate > 0.0) {
+        auto published = snapshot != nullptr && secondChannelSnapshot != nullptr
+            && snapshot->matches(previewSettings[0], sampleRate, doublePrecision)
+            && secondChannelSnapshot->matches(previewSettings[1], sampleRate, doublePrecision);
 
-    updateCutFilter(monoChain.get<ChainPositions::lowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+        if (published) {
+            usingPreview = false;
+        }
+        else {
+            // chỉ thiết kế lại khi param đổi (updateChain), các tick sau vẽ lại bản đã có
+            for (int channel = 0; channel < 2; ++channel) {
+                auto& preview = previewSnapshots[(size_t)channel];
+                if (!preview->matches(previewSettings[(size_t)channel], sampleRate, false))
+                    preview->design(previewSettings[(size_t)channel], sampleRate, 0, nullptr, false);
+            }
+
+            auto linked = previewSettings[0].stereoMode == StereoMode::Linked;
+            snapshot = previewSnapshots[0];
+            secondChannelSnapshot = linked ? previewSnapshots[0] : previewSnapshots[1];
+        }
+    }
+
+    // L/R hoặc M/S: vẽ thêm đường của kênh thứ 2
+    showSecondChannel = secondChannelSnapshot != nullptr && secondChannelSnapshot != snapshot;
 }
 
-void ResponseCurveComponent::paint(juce::Graphics& g)
-{
+juce::Path ResponseCurveComponent::createResponseCurve(const CoefficientSnapshot& chainSnapshot, juce::Rectangle<int> responseArea) {
     using namespace juce;
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll(Colours::black);
-
-    // Vẽ lưới
-    g.drawImage(background, getLocalBounds().toFloat());
-        
-    auto responseArea = getAnalysisArea(); 
 
     auto w = responseArea.getWidth();
 
-    auto& lowCut = monoChain.get<ChainPositions::lowCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
-    auto& highCut = monoChain.get<ChainPositions::HighCut>();
-
-    auto sampleRate = audioProcessor.getSampleRate();
-
     std::vector<double> mags;
 
     mags.resize(w);
 
     for (int i = 0; i < w; i++) {
-        // gain unit: có thể nhân
-        double mag = 1.f;
         // ánh xạ từ kgian điểm ảnh sang k gian tần số
         auto freq = mapToLog10((double(i) / double(w)), 20.0, 20000.0);
 
-        // Tăng từ trái qua phải mag = mag * ...
-        if (!monoChain.isBypassed<ChainPositions::Peak>())
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-        if (!monoChain.isBypassed<ChainPositions::lowCut>()) {
-            if (!lowCut.isBypassed<0>())
-                mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowCut.isBypassed<1>())
-                mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowCut.isBypassed<2>())
-                mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowCut.isBypassed<3>())
-                mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
-
-        if (!monoChain.isBypassed<ChainPositions::HighCut>()) {
-            if (!highCut.isBypassed<0>())
-                mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highCut.isBypassed<1>())
-                mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highCut.isBypassed<2>())
-                mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highCut.isBypassed<3>())
-                mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
+        // tích |H| của các tầng đang bật, tính trên chính các hệ số audio thread đang dùng
+        auto mag = chainSnapshot.getMagnitudeForFrequency(freq);
 
         // convert this magnitude into dB and store
         mags[i] = Decibels::gainToDecibels(mag);
@@ -412,27 +462,186 @@ void ResponseCurveComponent::paint(juce::Graphics& g)
         responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
     }
 
-    if (shouldShowFFTAnalysis) {
-        // phổ kênh trái
-        auto leftChannelFFTPath = leftPathProducer.getPath();
-        leftChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
-        g.setColour(Colours::skyblue);
-        g.strokePath(leftChannelFFTPath, PathStrokeType(1.f));
-
-        // // phổ kênh phải
-        auto rightChannelFFTPath = rightPathProducer.getPath();
-        rightChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
-        g.setColour(Colours::lightyellow);
-        g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
+    return responseCurve;
+}
+
+void ResponseCurveComponent::paint(juce::Graphics& g)
+{
+    using namespace juce;
+    // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll(Colours::black);
+
+    // Vẽ lưới
+    g.drawImage(background, getLocalBounds().toFloat());
+        
+    auto responseArea = getAnalysisArea(); 
+
+    // chưa prepare thì chưa có snapshot nào để vẽ
+    juce::Path responseCurve;
+    if (snapshot != nullptr)
+        responseCurve = createResponseCurve(*snapshot, responseArea);
+
+    if (shouldShowFFTAnalysis && analyzerPipeline != nullptr) {
+        auto drawTrace = [&](AnalyzerPipeline::Trace trace, Colour colour) {
+            auto path = analyzerPipeline->getPath(trace);
+            path.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+            g.setColour(colour);
+            g.strokePath(path, PathStrokeType(1.f));
+        };
+
+        // phổ trước EQ nằm dưới cùng, mờ
+        if (showPreTrace)
+            drawTrace(AnalyzerPipeline::Pre, Colours::white.withAlpha(0.35f));
+
+        if (spectrogram != nullptr) {
+            // lịch sử không vẽ lại: chỉ blit ring 2 đoạn
+            spectrogram->draw(g, responseArea);
+        }
+        else {
+            // phổ kênh trái
+            drawTrace(AnalyzerPipeline::PostLeft, Colours::skyblue);
+
+            // phổ kênh phải
+            drawTrace(AnalyzerPipeline::PostRight, Colours::lightyellow);
+        }
+
+        // EQ thực sự làm gì với tín hiệu: cùng thang +-24 dB với đường phản hồi
+        if (showDifferenceTrace)
+            drawTrace(AnalyzerPipeline::Difference, Colours::limegreen);
+
+        if (showStereoMeters)
+            drawStereoMeters(g, responseArea);
     }
     
     // vẽ viền bao quanh (render area)
     g.setColour(Colours::orange);
     g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
 
+    // kênh thứ 2 (phải / side) vẽ bên dưới đường chính
+    if (showSecondChannel) {
+        g.setColour(Colours::orange.withAlpha(0.8f));
+        g.strokePath(createResponseCurve(*secondChannelSnapshot, responseArea), PathStrokeType(1.5f));
+    }
+
     // vẽ đường thẳng màu trắng
     g.setColour(Colours::white);
     g.strokePath(responseCurve, PathStrokeType(2.f));
+
+    if (audioProcessor.isMeteringEnabled())
+        drawLoudness(g, responseArea);
+
+    drawMatchStatus(g, responseArea);
+}
+
+void ResponseCurveComponent::drawLoudness(juce::Graphics& g, juce::Rectangle<int> analysisArea) {
+    using namespace juce;
+
+    auto readings = audioProcessor.getLoudnessReadings();
+
+    // chưa đủ dữ liệu (hoặc im lặng): -inf
+    auto format = [](float value) {
+        return std::isfinite(value) ? String(value, 1) : String("-inf");
+    };
+
+    String text;
+    text << "M " << format(readings.momentary)
+         << "  S " << format(readings.shortTerm)
+         << "  I " << format(readings.integrated) << " LUFS"
+         << "  TP " << format(readings.truePeak) << " dBTP";
+
+    // gain bù đang áp (2 giá trị khi 2 kênh khác nhau)
+    if (audioProcessor.apvts.getRawParameterValue("Auto Gain")->load() > 0.5f) {
+        auto first = audioProcessor.getAutoGainDecibels(0), second = audioProcessor.getAutoGainDecibels(1);
+        text << "  AG " << String(first, 1);
+        if (std::abs(first - second) >= 0.05f)
+            text << " / " << String(second, 1);
+        text << " dB";
+    }
+
+    auto area = analysisArea.reduced(4, 2).removeFromTop(14);
+    g.setFont(11.f);
+
+    // true peak quá 0 dBTP: đỏ
+    g.setColour(readings.truePeak > 0.f ? Colours::red : Colours::lightgrey);
+    g.drawFittedText(text, area, Justification::centredLeft, 1);
+}
+
+void ResponseCurveComponent::drawMatchStatus(juce::Graphics& g, juce::Rectangle<int> analysisArea) {
+    using namespace juce;
+
+    auto& matchEq = getMatchEq();
+    auto sourceFrames = matchEq.getNumFrames(MatchEq::Source);
+    auto referenceFrames = matchEq.getNumFrames(MatchEq::Reference);
+    auto pendingFiles = matchEq.getNumPendingFiles();
+
+    // chưa dùng match EQ: không vẽ gì
+    if (sourceFrames == 0 && referenceFrames == 0 && pendingFiles == 0 && !matchEq.isLiveCapturing())
+        return;
+
+    String text;
+    text << "Match  source " << sourceFrames << (matchEq.isLiveCapturing(MatchEq::Source) ? "*" : "")
+         << "  reference " << referenceFrames << (matchEq.isLiveCapturing(MatchEq::Reference) ? "*" : "");
+
+    if (pendingFiles > 0)
+        text << "  files " << pendingFiles;
+
+    if (matchEq.isFitting())
+        text << "  fit " << roundToInt(matchEq.getFitProgress() * 100.f) << "% (" << String(matchEq.getFitError(), 1) << " dB)";
+
+    // dòng thứ 2, dưới loudness
+    auto area = analysisArea.reduced(4, 2).withTrimmedTop(14).removeFromTop(14);
+    g.setFont(11.f);
+    g.setColour(Colours::lightgrey);
+    g.drawFittedText(text, area, Justification::centredLeft, 1);
+}
+
+void ResponseCurveComponent::drawStereoMeters(juce::Graphics& g, juce::Rectangle<int> analysisArea) {
+    using namespace juce;
+
+    const auto& stereo = analyzerPipeline->getStereoAnalysis();
+    auto area = analysisArea.toFloat();
+
+    // tương quan pha theo dải: cột quanh đường giữa của dải 20 px dưới đáy, đúng x của tần số giữa dải
+    auto bandStrip = area.withTop(area.getBottom() - 20.f);
+    auto bandWidth = area.getWidth() / 30.f;
+    for (int band = 0; band < StereoAnalysis::numBands; ++band) {
+        auto correlation = stereo.getBandCorrelation(band);
+        auto x = area.getX() + area.getWidth() * mapFromLog10(StereoAnalysis::getBandCentre(band), 20.f, 20000.f);
+        auto height = bandStrip.getHeight() * 0.5f * std::abs(correlation);
+        auto top = correlation >= 0.f ? bandStrip.getCentreY() - height : bandStrip.getCentreY();
+
+        g.setColour(correlation >= 0.f ? Colours::limegreen.withAlpha(0.7f) : Colours::red.withAlpha(0.8f));
+        g.fillRect(x - bandWidth * 0.5f, top, bandWidth, height);
+    }
+
+    // goniometer vuông ở góc trên phải, thanh tương quan ngay dưới
+    auto size = jmin(area.getHeight() - 40.f, 110.f);
+    if (size <= 20.f)
+        return;
+
+    auto scope = Rectangle<float>(area.getRight() - size - 6.f, area.getY() + 6.f, size, size);
+    g.setColour(Colours::black.withAlpha(0.6f));
+    g.fillRect(scope);
+    g.setColour(Colours::dimgrey);
+    g.drawRect(scope);
+    g.drawLine(scope.getCentreX(), scope.getY(), scope.getCentreX(), scope.getBottom());
+
+    auto radius = size * 0.5f;
+    g.setColour(Colours::skyblue.withAlpha(0.6f));
+    for (const auto& point : stereo.getPoints()) {
+        auto x = scope.getCentreX() + jlimit(-1.f, 1.f, point.x) * radius;
+        auto y = scope.getCentreY() - jlimit(-1.f, 1.f, point.y) * radius;
+        g.fillRect(x, y, 1.f, 1.f);
+    }
+
+    auto meter = Rectangle<float>(scope.getX(), scope.getBottom() + 4.f, size, 6.f);
+    g.setColour(Colours::darkgrey);
+    g.fillRect(meter);
+
+    auto correlation = stereo.getCorrelation();
+    auto markerX = jmap(correlation, -1.f, 1.f, meter.getX(), meter.getRight());
+    g.setColour(correlation >= 0.f ? Colours::limegreen : Colours::red);
+    g.fillRect(markerX - 1.5f, meter.getY() - 1.f, 3.f, meter.getHeight() + 2.f);
 }
 
 void ResponseCurveComponent::resized() {
@@ -572,20 +781,21 @@ AudioPluginBetaAudioProcessorEditor::AudioPluginBetaAudioProcessorEditor(AudioPl
     lowCutSlopeSlider(*audioProcessor.apvts.getParameter("LowCut Slope"), "dB/Oct"),
     highCutFreqSlider(*audioProcessor.apvts.getParameter("HighCut Freq"), "Hz"),
     highCutSlopeSlider(*audioProcessor.apvts.getParameter("HighCut Slope"), "dB/Oct"),
+    peakThresholdSlider(*audioProcessor.apvts.getParameter("Peak Threshold"), "dB"),
+    peakRatioSlider(*audioProcessor.apvts.getParameter("Peak Ratio"), ":1"),
+    peakAttackSlider(*audioProcessor.apvts.getParameter("Peak Attack"), "ms"),
+    peakReleaseSlider(*audioProcessor.apvts.getParameter("Peak Release"), "ms"),
+    bandFreqSlider(*audioProcessor.apvts.getParameter(getBandParameterID(0, "Freq")), "Hz"),
+    bandGainSlider(*audioProcessor.apvts.getParameter(getBandParameterID(0, "Gain")), "dB"),
+    bandQualitySlider(*audioProcessor.apvts.getParameter(getBandParameterID(0, "Quality")), ""),
 
     responseCurveComponent(audioProcessor),
-    peakFreqSliderAttachment(audioProcessor.apvts, "Peak Freq", peakFreqSlider),
-    peakGainSliderAttachment(audioProcessor.apvts, "Peak Gain", peakGainSlider),
-    peakQualitySliderAttachment(audioProcessor.apvts, "Peak Quality", peakQualitySlider),
-    lowCutFreqSliderAttachment(audioProcessor.apvts, "LowCut Freq", lowCutFreqSlider),
-    lowCutSlopeSliderAttachment(audioProcessor.apvts, "LowCut Slope", lowCutSlopeSlider),
-    highCutFreqSliderAttachment(audioProcessor.apvts, "HighCut Freq", highCutFreqSlider),
-    highCutSlopeSliderAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlopeSlider),
-
-    lowCutBypassButtonAttachment(audioProcessor.apvts, "LowCut Bypassed", lowCutBypassButton),
-    peakBypassButtonAttachment(audioProcessor.apvts, "Peak Bypassed", peakBypassButton),
-    highCutBypassButtonAttachment(audioProcessor.apvts, "HighCut Bypassed", highCutBypassButton),
-    analyzerEnableButtonAttachment(audioProcessor.apvts, "Analyzer Enabled", analyzerEnableButton)
+    analyzerEnableButtonAttachment(audioProcessor.apvts, "Analyzer Enabled", analyzerEnableButton),
+    analogMatchedButtonAttachment(audioProcessor.apvts, "Analog Matched", analogMatchedButton),
+    sweepCacheButtonAttachment(audioProcessor.apvts, "Sweep Cache", sweepCacheButton),
+    meteringButtonAttachment(audioProcessor.apvts, "Metering", meteringButton),
+    autoGainButtonAttachment(audioProcessor.apvts, "Auto Gain", autoGainButton),
+    analyzerExportButtonAttachment(audioProcessor.apvts, "Analyzer Export", analyzerExportButton)
     {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -611,6 +821,55 @@ AudioPluginBetaAudioProcessorEditor::AudioPluginBetaAudioProcessorEditor(AudioPl
     highCutSlopeSlider.labels.add({ 0.f, "12" });
     highCutSlopeSlider.labels.add({ 1.f, "48" });
 
+    peakThresholdSlider.labels.add({ 0.f, "-60dB" });
+    peakThresholdSlider.labels.add({ 1.f, "0dB" });
+
+    peakRatioSlider.labels.add({ 0.f, "1:1" });
+    peakRatioSlider.labels.add({ 1.f, "10:1" });
+
+    peakAttackSlider.labels.add({ 0.f, "1ms" });
+    peakAttackSlider.labels.add({ 1.f, "100ms" });
+
+    peakReleaseSlider.labels.add({ 0.f, "5ms" });
+    peakReleaseSlider.labels.add({ 1.f, "500ms" });
+
+    bandFreqSlider.labels.add({ 0.f, "20Hz" });
+    bandFreqSlider.labels.add({ 1.f, "20kHz" });
+
+    bandGainSlider.labels.add({ 0.f, "-24dB" });
+    bandGainSlider.labels.add({ 1.f, "+24dB" });
+
+    bandQualitySlider.labels.add({ 0.f, "0.1" });
+    bandQualitySlider.labels.add({ 1.f, "10.0" });
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        juce::String str;
+        str << "Band " << (i + 1);
+        bandSelector.addItem(str, i + 1);
+    }
+    bandTypeBox.addItemList(getBandTypeNames(), 1);
+
+    stereoModeBox.addItemList(getStereoModeNames(), 1);
+    stereoModeBoxAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "Stereo Mode", stereoModeBox);
+
+    editChannelBox.addItem("Left / Mid", 1);
+    editChannelBox.addItem("Right / Side", 2);
+
+    topologyBox.addItemList(getFilterTopologyNames(), 1);
+    topologyBoxAttachment = std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, "Filter Topology", topologyBox);
+
+    // không có bank (file không ghi / map được) thì chỉ có 1 program không tên
+    for (int i = 0; i < audioProcessor.getNumPrograms(); ++i) {
+        auto name = audioProcessor.getProgramName(i);
+        if (name.isNotEmpty())
+            presetBox.addItem(name, i + 1);
+    }
+    presetBox.setTextWhenNothingSelected("Preset");
+    presetBox.setSelectedId(audioProcessor.getCurrentProgram() + 1, juce::dontSendNotification);
+    presetBox.setEnabled(presetBox.getNumItems() > 0);
+    // không có POSIX shared memory (Windows): không có gì để export
+    analyzerExportButton.setEnabled(AnalyzerExport::isSupported());
+
     for (auto* comp : getComps()) {
         addAndMakeVisible(comp);
     }
@@ -628,6 +887,13 @@ AudioPluginBetaAudioProcessorEditor::AudioPluginBetaAudioProcessorEditor(AudioPl
             comp->peakFreqSlider.setEnabled(!bypassed);
             comp->peakGainSlider.setEnabled(!bypassed);
             comp->peakQualitySlider.setEnabled(!bypassed);
+            comp->updateDynamicControlsEnablement();
+        }
+    };
+
+    peakDynamicButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->updateDynamicControlsEnablement();
         }
     };
 
@@ -657,7 +923,186 @@ AudioPluginBetaAudioProcessorEditor::AudioPluginBetaAudioProcessorEditor(AudioPl
         }
     };
 
-    setSize (600, 480);
+    bandSelector.onChange = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->selectBand(comp->bandSelector.getSelectedItemIndex());
+        }
+    };
+
+    editChannelBox.onChange = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->bindChannel(comp->editChannelBox.getSelectedItemIndex());
+        }
+    };
+
+    presetBox.onChange = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            auto id = comp->presetBox.getSelectedId();
+            if (id > 0)
+                comp->audioProcessor.setCurrentProgram(id - 1);
+        }
+    };
+
+    showPreButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->responseCurveComponent.setPreTraceVisible(comp->showPreButton.getToggleState());
+        }
+    };
+
+    showDifferenceButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->responseCurveComponent.setDifferenceTraceVisible(comp->showDifferenceButton.getToggleState());
+        }
+    };
+
+    showSpectrogramButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->responseCurveComponent.setSpectrogramVisible(comp->showSpectrogramButton.getToggleState());
+        }
+    };
+
+    showStereoButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->responseCurveComponent.setStereoMetersVisible(comp->showStereoButton.getToggleState());
+        }
+    };
+
+    resetLoudnessButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->audioProcessor.resetLoudness();
+        }
+    };
+
+    matchButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->showMatchMenu();
+        }
+    };
+
+    // solver xong (message thread): ghi vào kênh lúc bắt đầu fit; editor đã đóng thì bỏ kết quả
+    responseCurveComponent.getMatchEq().onFitFinished = [safePtr](const ChainSettings& settings, int channel) {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->audioProcessor.applyMatchedSettings(settings, channel);
+        }
+    };
+
+    compareAButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->audioProcessor.selectCompareSlot(0);
+            comp->updateCompareButtons();
+        }
+    };
+
+    compareBButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->audioProcessor.selectCompareSlot(1);
+            comp->updateCompareButtons();
+        }
+    };
+
+    stereoModeBox.onChange = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->updateEditChannelEnablement();
+        }
+    };
+
+    bandSelector.setSelectedItemIndex(0, juce::dontSendNotification);
+    editChannelBox.setSelectedItemIndex(0, juce::dontSendNotification);
+    bindChannel(0);
+    updateEditChannelEnablement();
+    updateCompareButtons();
+
+    setSize (700, 705);
+}
+
+void AudioPluginBetaAudioProcessorEditor::bindChannel(int channel) {
+    if (!juce::isPositiveAndBelow(channel, 2))
+        return;
+
+    auto& apvts = audioProcessor.apvts;
+    editedChannel = channel;
+    channelPrefix = getChannelParameterPrefix(channel);
+
+    auto bindSlider = [&apvts, this](std::unique_ptr<Attachment>& attachment, RotarySliderWithLabels& slider, const juce::String& name) {
+        // huỷ attachment cũ trước để slider không ghi ngược vào kênh trước đó
+        attachment.reset();
+        slider.setParameter(*apvts.getParameter(channelPrefix + name));
+        attachment = std::make_unique<Attachment>(apvts, channelPrefix + name, slider);
+    };
+
+    auto bindButton = [&apvts, this](std::unique_ptr<ButtonAttachment>& attachment, juce::Button& button, const juce::String& name) {
+        attachment.reset();
+        attachment = std::make_unique<ButtonAttachment>(apvts, channelPrefix + name, button);
+    };
+
+    bindSlider(peakFreqSliderAttachment, peakFreqSlider, "Peak Freq");
+    bindSlider(peakGainSliderAttachment, peakGainSlider, "Peak Gain");
+    bindSlider(peakQualitySliderAttachment, peakQualitySlider, "Peak Quality");
+    bindSlider(lowCutFreqSliderAttachment, lowCutFreqSlider, "LowCut Freq");
+    bindSlider(lowCutSlopeSliderAttachment, lowCutSlopeSlider, "LowCut Slope");
+    bindSlider(highCutFreqSliderAttachment, highCutFreqSlider, "HighCut Freq");
+    bindSlider(highCutSlopeSliderAttachment, highCutSlopeSlider, "HighCut Slope");
+    bindSlider(peakThresholdSliderAttachment, peakThresholdSlider, "Peak Threshold");
+    bindSlider(peakRatioSliderAttachment, peakRatioSlider, "Peak Ratio");
+    bindSlider(peakAttackSliderAttachment, peakAttackSlider, "Peak Attack");
+    bindSlider(peakReleaseSliderAttachment, peakReleaseSlider, "Peak Release");
+
+    bindButton(lowCutBypassButtonAttachment, lowCutBypassButton, "LowCut Bypassed");
+    bindButton(peakBypassButtonAttachment, peakBypassButton, "Peak Bypassed");
+    bindButton(highCutBypassButtonAttachment, highCutBypassButton, "HighCut Bypassed");
+    bindButton(peakDynamicButtonAttachment, peakDynamicButton, "Peak Dynamic");
+    bindButton(peakSidechainButtonAttachment, peakSidechainButton, "Peak Sidechain");
+
+    // attachment đặt toggle state không gọi onClick, cập nhật enable bằng tay
+    lowCutBypassButton.onClick();
+    highCutBypassButton.onClick();
+    peakBypassButton.onClick();
+
+    selectBand(bandSelector.getSelectedItemIndex());
+}
+
+void AudioPluginBetaAudioProcessorEditor::updateEditChannelEnablement() {
+    auto linked = stereoModeBox.getSelectedItemIndex() == StereoMode::Linked;
+
+    // linked: chỉ có bộ tham số của kênh đầu
+    if (linked && editChannelBox.getSelectedItemIndex() != 0)
+        editChannelBox.setSelectedItemIndex(0, juce::sendNotificationSync);
+
+    editChannelBox.setEnabled(!linked);
+}
+
+void AudioPluginBetaAudioProcessorEditor::selectBand(int band) {
+    if (!juce::isPositiveAndBelow(band, MaxParametricBands))
+        return;
+
+    auto& apvts = audioProcessor.apvts;
+
+    // huỷ attachment cũ trước để slider không ghi ngược vào band trước đó
+    bandFreqSliderAttachment.reset();
+    bandGainSliderAttachment.reset();
+    bandQualitySliderAttachment.reset();
+    bandEnabledButtonAttachment.reset();
+    bandTypeBoxAttachment.reset();
+
+    bandFreqSlider.setParameter(*apvts.getParameter(channelPrefix + getBandParameterID(band, "Freq")));
+    bandGainSlider.setParameter(*apvts.getParameter(channelPrefix + getBandParameterID(band, "Gain")));
+    bandQualitySlider.setParameter(*apvts.getParameter(channelPrefix + getBandParameterID(band, "Quality")));
+
+    bandFreqSliderAttachment = std::make_unique<Attachment>(apvts, channelPrefix + getBandParameterID(band, "Freq"), bandFreqSlider);
+    bandGainSliderAttachment = std::make_unique<Attachment>(apvts, channelPrefix + getBandParameterID(band, "Gain"), bandGainSlider);
+    bandQualitySliderAttachment = std::make_unique<Attachment>(apvts, channelPrefix + getBandParameterID(band, "Quality"), bandQualitySlider);
+    bandEnabledButtonAttachment = std::make_unique<ButtonAttachment>(apvts, channelPrefix + getBandParameterID(band, "Enabled"), bandEnabledButton);
+    bandTypeBoxAttachment = std::make_unique<APVTS::ComboBoxAttachment>(apvts, channelPrefix + getBandParameterID(band, "Type"), bandTypeBox);
+}
+
+void AudioPluginBetaAudioProcessorEditor::updateDynamicControlsEnablement() {
+    auto enabled = peakDynamicButton.getToggleState() && !peakBypassButton.getToggleState();
+
+    peakSidechainButton.setEnabled(enabled);
+    peakThresholdSlider.setEnabled(enabled);
+    peakRatioSlider.setEnabled(enabled);
+    peakAttackSlider.setEnabled(enabled);
+    peakReleaseSlider.setEnabled(enabled);
 }
 
 AudioPluginBetaAudioProcessorEditor::~AudioPluginBetaAudioProcessorEditor()
@@ -685,11 +1130,47 @@ void AudioPluginBetaAudioProcessorEditor::resized()
     auto bounds = getLocalBounds();
 
     auto analyzerEnabledArea = bounds.removeFromTop(25);
-    analyzerEnabledArea.setWidth(100);
-    analyzerEnabledArea.setX(5);
+
+    // nút chọn thiết kế matched ở góc phải hàng trên cùng
+    auto analogMatchedArea = analyzerEnabledArea.removeFromRight(120);
+    analogMatchedArea.removeFromTop(2);
+    analogMatchedButton.setBounds(analogMatchedArea);
+
+    auto sweepCacheArea = analyzerEnabledArea.removeFromRight(100);
+    sweepCacheArea.removeFromTop(2);
+    sweepCacheButton.setBounds(sweepCacheArea);
+
+    auto autoGainArea = analyzerEnabledArea.removeFromRight(80);
+    autoGainArea.removeFromTop(2);
+    autoGainButton.setBounds(autoGainArea);
+
+    analyzerEnabledArea.removeFromLeft(5);
     analyzerEnabledArea.removeFromTop(2);
 
-    analyzerEnableButton.setBounds(analyzerEnabledArea);
+    analyzerEnableButton.setBounds(analyzerEnabledArea.removeFromLeft(90));
+
+    // chế độ stereo + kênh đang chỉnh, cạnh nút analyzer
+    stereoModeBox.setBounds(analyzerEnabledArea.removeFromLeft(110).reduced(4, 0));
+    editChannelBox.setBounds(analyzerEnabledArea.removeFromLeft(120).reduced(4, 0));
+    topologyBox.setBounds(analyzerEnabledArea.removeFromLeft(80).reduced(4, 0));
+
+    // hàng thứ 2: preset + A/B, các lớp phủ của analyzer, meter
+    auto presetArea = bounds.removeFromTop(25);
+    presetArea.removeFromLeft(5);
+    presetArea.removeFromTop(2);
+    presetBox.setBounds(presetArea.removeFromLeft(110).reduced(4, 0));
+    compareAButton.setBounds(presetArea.removeFromLeft(30).reduced(2, 0));
+    compareBButton.setBounds(presetArea.removeFromLeft(30).reduced(2, 0));
+
+    presetArea.removeFromLeft(10);
+    showPreButton.setBounds(presetArea.removeFromLeft(55));
+    showDifferenceButton.setBounds(presetArea.removeFromLeft(55));
+    showSpectrogramButton.setBounds(presetArea.removeFromLeft(100));
+    showStereoButton.setBounds(presetArea.removeFromLeft(70));
+    meteringButton.setBounds(presetArea.removeFromLeft(65));
+    resetLoudnessButton.setBounds(presetArea.removeFromLeft(50).reduced(2, 0));
+    matchButton.setBounds(presetArea.removeFromLeft(55).reduced(2, 0));
+    analyzerExportButton.setBounds(presetArea.removeFromLeft(65));
 
     bounds.removeFromTop(5);
 
@@ -700,6 +1181,31 @@ void AudioPluginBetaAudioProcessorEditor::resized()
 
     bounds.removeFromTop(5);
 
+    // dải chỉnh các band tham số
+    auto bandArea = bounds.removeFromBottom(100);
+    auto bandControlsArea = bandArea.removeFromLeft(100);
+    auto bandControlHeight = bandControlsArea.getHeight() / 3;
+    bandSelector.setBounds(bandControlsArea.removeFromTop(bandControlHeight).reduced(4, 2));
+    bandTypeBox.setBounds(bandControlsArea.removeFromTop(bandControlHeight).reduced(4, 2));
+    bandEnabledButton.setBounds(bandControlsArea.reduced(4, 2));
+
+    auto bandSliderWidth = bandArea.getWidth() / 3;
+    bandFreqSlider.setBounds(bandArea.removeFromLeft(bandSliderWidth));
+    bandGainSlider.setBounds(bandArea.removeFromLeft(bandSliderWidth));
+    bandQualitySlider.setBounds(bandArea);
+
+    // phía trên dải band: dynamic EQ của band Peak
+    auto dynamicArea = bounds.removeFromBottom(100);
+    auto dynamicButtonsArea = dynamicArea.removeFromLeft(100);
+    peakDynamicButton.setBounds(dynamicButtonsArea.removeFromTop(dynamicButtonsArea.getHeight() / 2).reduced(4));
+    peakSidechainButton.setBounds(dynamicButtonsArea.reduced(4));
+
+    auto dynamicSliderWidth = dynamicArea.getWidth() / 4;
+    peakThresholdSlider.setBounds(dynamicArea.removeFromLeft(dynamicSliderWidth));
+    peakRatioSlider.setBounds(dynamicArea.removeFromLeft(dynamicSliderWidth));
+    peakAttackSlider.setBounds(dynamicArea.removeFromLeft(dynamicSliderWidth));
+    peakReleaseSlider.setBounds(dynamicArea);
+
     auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.33);
     auto highCutArea = bounds.removeFromRight(bounds.getWidth() * 0.5);
 
@@ -718,6 +1224,70 @@ void AudioPluginBetaAudioProcessorEditor::resized()
 
 }
 
+void AudioPluginBetaAudioProcessorEditor::showMatchMenu() {
+    auto& matchEq = responseCurveComponent.getMatchEq();
+    auto idle = !matchEq.isFitting();
+
+    // live capture đọc tap trước EQ của analyzer: chỉ có khi analyzer bật
+    auto analyzerOn = analyzerEnableButton.getToggleState();
+
+    juce::PopupMenu menu;
+    menu.addItem(1, "Capture Source (live)", analyzerOn && idle, matchEq.isLiveCapturing(MatchEq::Source));
+    menu.addItem(2, "Capture Reference (live)", analyzerOn && idle, matchEq.isLiveCapturing(MatchEq::Reference));
+    menu.addItem(3, "Add Source Files...", idle);
+    menu.addItem(4, "Add Reference Files...", idle);
+    menu.addSeparator();
+    menu.addItem(5, "Fit Cut + Peak", matchEq.canFit());
+    menu.addItem(6, "Cancel Fit", !idle);
+    menu.addItem(7, "Clear", idle);
+
+    auto safePtr = juce::Component::SafePointer<AudioPluginBetaAudioProcessorEditor>(this);
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&matchButton), [safePtr](int result) {
+        auto* comp = safePtr.getComponent();
+        if (comp == nullptr)
+            return;
+
+        auto& curve = comp->responseCurveComponent;
+        auto& matchEq = curve.getMatchEq();
+
+        switch (result) {
+        case 1: curve.setMatchCapture(MatchEq::Source, !matchEq.isLiveCapturing(MatchEq::Source)); break;
+        case 2: curve.setMatchCapture(MatchEq::Reference, !matchEq.isLiveCapturing(MatchEq::Reference)); break;
+        case 3: comp->chooseMatchFiles(MatchEq::Source); break;
+        case 4: comp->chooseMatchFiles(MatchEq::Reference); break;
+        case 5: matchEq.startFit(getChainSettings(comp->audioProcessor.apvts, comp->channelPrefix), comp->audioProcessor.getSampleRate(),
+                                 comp->editedChannel); break;
+        case 6: matchEq.cancelFit(); break;
+        case 7:
+            curve.setMatchCapture(MatchEq::Source, false);
+            curve.setMatchCapture(MatchEq::Reference, false);
+            matchEq.clear();
+            break;
+        default: break;
+        }
+    });
+}
+
+void AudioPluginBetaAudioProcessorEditor::chooseMatchFiles(MatchEq::Target target) {
+    matchFileChooser = std::make_unique<juce::FileChooser>(target == MatchEq::Source ? "Source files" : "Reference files",
+        juce::File(), MatchEq::getFileWildcard());
+
+    auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles
+        | juce::FileBrowserComponent::canSelectMultipleItems;
+
+    auto safePtr = juce::Component::SafePointer<AudioPluginBetaAudioProcessorEditor>(this);
+    matchFileChooser->launchAsync(flags, [safePtr, target](const juce::FileChooser& chooser) {
+        if (auto* comp = safePtr.getComponent())
+            comp->responseCurveComponent.getMatchEq().analyseFiles(chooser.getResults(), target);
+    });
+}
+
+void AudioPluginBetaAudioProcessorEditor::updateCompareButtons() {
+    auto slot = audioProcessor.getActiveCompareSlot();
+    compareAButton.setToggleState(slot == 0, juce::dontSendNotification);
+    compareBButton.setToggleState(slot == 1, juce::dontSendNotification);
+}
+
 std::vector<juce::Component*> AudioPluginBetaAudioProcessorEditor::getComps() {
 
     return {
@@ -728,12 +1298,44 @@ std::vector<juce::Component*> AudioPluginBetaAudioProcessorEditor::getComps() {
         &highCutFreqSlider,
         &lowCutSlopeSlider,
         &highCutSlopeSlider,
+        &peakThresholdSlider,
+        &peakRatioSlider,
+        &peakAttackSlider,
+        &peakReleaseSlider,
+        &bandFreqSlider,
+        &bandGainSlider,
+        &bandQualitySlider,
         &responseCurveComponent,
         
         &lowCutBypassButton,
         &peakBypassButton,
         &highCutBypassButton,
-        &analyzerEnableButton
+        &analyzerEnableButton,
+        &analogMatchedButton,
+        &sweepCacheButton,
+        &meteringButton,
+        &autoGainButton,
+        &peakDynamicButton,
+        &peakSidechainButton,
+
+        &bandSelector,
+        &bandTypeBox,
+        &bandEnabledButton,
+
+        &stereoModeBox,
+        &editChannelBox,
+        &topologyBox,
+
+        &presetBox,
+        &compareAButton,
+        &compareBButton,
+        &showPreButton,
+        &showDifferenceButton,
+        &showSpectrogramButton,
+        &showStereoButton,
+        &resetLoudnessButton,
+        &matchButton,
+        &analyzerExportButton
     };
 }
 
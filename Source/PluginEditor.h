@@ -10,162 +10,9 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
-
-enum FFTOrder {
-    order2048 = 11,
-    order4096,
-    order8192
-};
-
-// lấy dữ liệu block từ fifo để biến đổi dữ liệu âm thanh thành dữ liệu FFT
-template<typename BlockType>
-struct FFTDataGenerator
-{
-    /**
-     produces the FFT data from an audio buffer.
-     */
-    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
-    {
-        const auto fftSize = getFFTSize();
-
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
-
-        // first apply a windowing function to our data
-        window->multiplyWithWindowingTable(fftData.data(), fftSize);       // [1]
-
-        // then render our FFT data..
-        forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());  // [2]
-
-        int numBins = (int)fftSize / 2;
-
-        //normalize the fft values.
-        for (int i = 0; i < numBins; ++i)
-        {
-            auto v = fftData[i];
-            //            fftData[i] /= (float) numBins;
-            if (!std::isinf(v) && !std::isnan(v))
-            {
-                v /= float(numBins);
-            }
-            else
-            {
-                v = 0.f;
-            }
-            fftData[i] = v;
-        }
-
-        //convert them to decibels
-        for (int i = 0; i < numBins; ++i)
-        {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
-        }
-
-        fftDataFifo.push(fftData);
-    }
-
-    void changeOrder(FFTOrder newOrder)
-    {
-        //when you change order, recreate the window, forwardFFT, fifo, fftData
-        //also reset the fifoIndex
-        //things that need recreating should be created on the heap via std::make_unique<>
-
-        order = newOrder;
-        auto fftSize = getFFTSize();
-
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
-
-        fftData.clear();
-        fftData.resize(fftSize * 2, 0);
-
-        fftDataFifo.prepare(fftData.size());
-    }
-    //==============================================================================
-    int getFFTSize() const { return 1 << order; }
-    int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
-    //==============================================================================
-    bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
-private:
-    FFTOrder order;
-    BlockType fftData;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
-
-    Fifo<BlockType> fftDataFifo;
-};
-
-// Biến đổi FFT data thành path
-template<typename PathType>
-struct AnalyzerPathGenerator
-{
-    /*
-     converts 'renderData[]' into a juce::Path
-     */
-    void generatePath(const std::vector<float>& renderData,
-        juce::Rectangle<float> fftBounds,
-        int fftSize,
-        float binWidth,
-        float negativeInfinity)
-    {
-        auto top = fftBounds.getY();
-        auto bottom = fftBounds.getHeight();
-        auto width = fftBounds.getWidth();
-
-        int numBins = (int)fftSize / 2;
-
-        PathType p;
-        p.preallocateSpace(3 * (int)fftBounds.getWidth());
-
-        auto map = [bottom, top, negativeInfinity](float v)
-        {
-            return juce::jmap(v,
-                negativeInfinity, 0.f,
-                float(bottom), top);
-        };
-
-        auto y = map(renderData[0]);
-
-        //        jassert( !std::isnan(y) && !std::isinf(y) );
-        if (std::isnan(y) || std::isinf(y))
-            y = bottom;
-
-        p.startNewSubPath(0, y);
-
-        const int pathResolution = 2; //you can draw line-to's every 'pathResolution' pixels.
-
-        for (int binNum = 1; binNum < numBins; binNum += pathResolution)
-        {
-            y = map(renderData[binNum]);
-
-            //            jassert( !std::isnan(y) && !std::isinf(y) );
-
-            if (!std::isnan(y) && !std::isinf(y))
-            {
-                auto binFreq = binNum * binWidth;
-                auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-                int binX = std::floor(normalizedBinX * width);
-                p.lineTo(binX, y);
-            }
-        }
-
-        pathFifo.push(p);
-    }
-
-    int getNumPathsAvailable() const
-    {
-        return pathFifo.getNumAvailableForReading();
-    }
-
-    bool getPath(PathType& path)
-    {
-        return pathFifo.pull(path);
-    }
-private:
-    Fifo<PathType> pathFifo;
-};
-
+#include "AnalyzerPipeline.h"
+#include "Spectrogram.h"
+#include "MatchEq.h"
 
 struct LookAndFeel : juce::LookAndFeel_V4 {
     // tạo 1 bound hay nền cho cái rotary sliders
@@ -213,6 +60,12 @@ struct RotarySliderWithLabels : juce::Slider
 
     int getTextHeight() const { return 14; }
 
+    // dùng khi một slider được gắn lại sang param khác (dải band)
+    void setParameter(juce::RangedAudioParameter& rap) {
+        param = &rap;
+        repaint();
+    }
+
     juce::String getDisplayString() const;
 
 private:
@@ -226,34 +79,6 @@ private:
     juce::String suffix;
 };
 
-struct PathProducer {
-    PathProducer(SingleChannelSampleFifo < AudioPluginBetaAudioProcessor::BlockType >& scsf) :
-        leftChannelFifo(&scsf) {
-        leftChannelFFTDataGenerator.changeOrder(FFTOrder::order2048);
-        monoBuffer.setSize(1, leftChannelFFTDataGenerator.getFFTSize());
-    }
-
-    /*
-    Khi còn buffer để lấy từ scsf
-        nếu pull được thì
-            gửi nó đến fft data gen
-    Bao gồm cả gen path trong này
-    */
-    void process(juce::Rectangle<float> fftBounds, double sampleRate);
-    juce::Path getPath() { return leftChannelFFTPath; }
-
-private:
-    SingleChannelSampleFifo < AudioPluginBetaAudioProcessor::BlockType >* leftChannelFifo;
-
-    juce::AudioBuffer<float> monoBuffer;
-
-    FFTDataGenerator<std::vector<float>> leftChannelFFTDataGenerator;
-
-    AnalyzerPathGenerator<juce::Path> pathProducer;
-
-    juce::Path leftChannelFFTPath;
-};
-
 // Lớp vẽ đường cong phản hồi
 // kế thừa listener: 
 // kế thùa timer: 
@@ -279,17 +104,43 @@ struct ResponseCurveComponent : juce::Component,
 
     void toggleAnalysisEnablement(bool enabled) {
         shouldShowFFTAnalysis = enabled;
+        updateAnalyzerStorage();
     }
+
+    // phổ trước EQ và chênh lệch sau - trước EQ (chỉ phân tích tap trước EQ khi có đường cần vẽ)
+    void setPreTraceVisible(bool visible);
+    void setDifferenceTraceVisible(bool visible);
+
+    // waterfall của phổ sau EQ thay cho 2 đường L / R
+    void setSpectrogramVisible(bool visible);
+
+    // goniometer + tương quan + tương quan pha theo dải octave
+    void setStereoMetersVisible(bool visible);
+
+    // phổ dài hạn source / reference + solver (live capture lấy từ tap trước EQ của analyzer)
+    MatchEq& getMatchEq() { return audioProcessor.getMatchEq(); }
+    void setMatchCapture(MatchEq::Target target, bool shouldCapture);
 private:
     AudioPluginBetaAudioProcessor& audioProcessor;
 
     // kiểm tra xem param có thay đổi?
     juce::Atomic<bool> parameterChanged{ false };
 
-    MonoChain monoChain;
+    // snapshot hệ số của processor (dùng chung với audio thread), kênh thứ 2 chỉ vẽ khi không linked
+    CoefficientSnapshot::Ptr snapshot, secondChannelSnapshot;
+    bool showSecondChannel = false;
+
+    // host không gọi processBlock (transport dừng...) thì audio thread chưa publish:
+    // vẽ tạm từ bản thiết kế riêng của GUI (không vào pool), tới khi bản publish khớp param
+    std::array<CoefficientSnapshot::Ptr, 2> previewSnapshots{ new CoefficientSnapshot(), new CoefficientSnapshot() };
+    std::array<ChainSettings, 2> previewSettings;
+    bool usingPreview = false;
 
     // dùng này để gọn và để nó tự lưu mỗi khi khởi động gui
     void updateChain();
+    void refreshSnapshots();
+
+    juce::Path createResponseCurve(const CoefficientSnapshot& chainSnapshot, juce::Rectangle<int> responseArea);
 
     // background của cái response curve grid
     juce::Image background;
@@ -301,9 +152,30 @@ private:
     // response curve cũng được vẽ trong này
     juce::Rectangle<int> getAnalysisArea();
     
-    PathProducer leftPathProducer, rightPathProducer;
+    // fifo của processor + FFT / path chỉ tồn tại khi analyzer bật, tắt thì trả lại hết
+    AnalyzerFifos::Ptr analyzerFifos;
+    std::unique_ptr<AnalyzerPipeline> analyzerPipeline;
+
+    // ảnh waterfall chỉ được cấp khi đang hiện (cùng kiểu fifo analyzer)
+    std::unique_ptr<Spectrogram> spectrogram;
+    static constexpr int spectrogramSeconds = 4;
+
+    void updateAnalyzerStorage();
+
+    void drawStereoMeters(juce::Graphics& g, juce::Rectangle<int> analysisArea);
+    // M / S / I (LUFS) + true peak của output, chỉ đọc atomic của processor
+    void drawLoudness(juce::Graphics& g, juce::Rectangle<int> analysisArea);
+    // số khung đã capture, file đang phân tích, tiến độ fit
+    void drawMatchStatus(juce::Graphics& g, juce::Rectangle<int> analysisArea);
+
+    // tap trước EQ cần cho đường pre / chênh lệch và cho live capture của match EQ
+    void updatePreAnalysis();
+
+    // ghi khung vừa phân tích vào ring shared memory của processor khi "Analyzer Export" bật
+    void publishAnalyzerExport(double sampleRate);
 
     bool shouldShowFFTAnalysis = true;
+    bool showPreTrace = false, showDifferenceTrace = false, showSpectrogram = false, showStereoMeters = false;
 };
 
 //==============================================================================
@@ -354,29 +226,102 @@ private:
                        lowCutFreqSlider,
                        highCutFreqSlider,
                        lowCutSlopeSlider,
-                       highCutSlopeSlider;
+                       highCutSlopeSlider,
+                       peakThresholdSlider,
+                       peakRatioSlider,
+                       peakAttackSlider,
+                       peakReleaseSlider,
+                       bandFreqSlider,
+                       bandGainSlider,
+                       bandQualitySlider;
 
     ResponseCurveComponent responseCurveComponent;
 
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
 
-    Attachment peakFreqSliderAttachment,
-               peakGainSliderAttachment,
-               peakQualitySliderAttachment,
-               lowCutFreqSliderAttachment,
-               highCutFreqSliderAttachment,
-               lowCutSlopeSliderAttachment,
-               highCutSlopeSliderAttachment;
+    // các tham số theo kênh: gắn lại khi đổi kênh đang chỉnh (L/R hoặc M/S)
+    std::unique_ptr<Attachment> peakFreqSliderAttachment,
+                                peakGainSliderAttachment,
+                                peakQualitySliderAttachment,
+                                lowCutFreqSliderAttachment,
+                                highCutFreqSliderAttachment,
+                                lowCutSlopeSliderAttachment,
+                                highCutSlopeSliderAttachment,
+                                peakThresholdSliderAttachment,
+                                peakRatioSliderAttachment,
+                                peakAttackSliderAttachment,
+                                peakReleaseSliderAttachment;
 
     PowerButton lowCutBypassButton, highCutBypassButton, peakBypassButton;
     AnalyzerButton analyzerEnableButton;
+    juce::ToggleButton analogMatchedButton{ "Analog Matched" };
+    juce::ToggleButton sweepCacheButton{ "Sweep Cache" };
+    juce::ToggleButton meteringButton{ "Meter" };
+    juce::ToggleButton autoGainButton{ "Auto Gain" };
+    juce::ToggleButton analyzerExportButton{ "Export" };
+    juce::ToggleButton peakDynamicButton{ "Dynamic" }, peakSidechainButton{ "Sidechain" };
     
     using ButtonAttachment = APVTS::ButtonAttachment;
-    ButtonAttachment lowCutBypassButtonAttachment, 
-                     highCutBypassButtonAttachment, 
-                     peakBypassButtonAttachment, 
-                     analyzerEnableButtonAttachment;
+    ButtonAttachment analyzerEnableButtonAttachment,
+                     analogMatchedButtonAttachment,
+                     sweepCacheButtonAttachment,
+                     meteringButtonAttachment,
+                     autoGainButtonAttachment,
+                     analyzerExportButtonAttachment;
+
+    std::unique_ptr<ButtonAttachment> lowCutBypassButtonAttachment,
+                                      highCutBypassButtonAttachment,
+                                      peakBypassButtonAttachment,
+                                      peakDynamicButtonAttachment,
+                                      peakSidechainButtonAttachment;
+
+    // chế độ stereo và kênh đang chỉnh
+    juce::ComboBox stereoModeBox, editChannelBox;
+    std::unique_ptr<APVTS::ComboBoxAttachment> stereoModeBoxAttachment;
+
+    // backend lọc (biquad / SVF)
+    juce::ComboBox topologyBox;
+    std::unique_ptr<APVTS::ComboBoxAttachment> topologyBoxAttachment;
+    juce::String channelPrefix;
+    int editedChannel = 0;
+
+    // preset trong bank của processor + 2 slot A/B
+    juce::ComboBox presetBox;
+    juce::TextButton compareAButton{ "A" }, compareBButton{ "B" };
+
+    // thêm đường phổ trước EQ / chênh lệch vào analyzer
+    juce::ToggleButton showPreButton{ "Pre" }, showDifferenceButton{ "Diff" };
+    juce::ToggleButton showSpectrogramButton{ "Spectrogram" }, showStereoButton{ "Stereo" };
+
+    // xoá integrated loudness + true peak max
+    juce::TextButton resetLoudnessButton{ "Reset" };
+
+    // menu match EQ: capture live / từ file, fit, kết quả ghi vào kênh đang chỉnh
+    juce::TextButton matchButton{ "Match" };
+    std::unique_ptr<juce::FileChooser> matchFileChooser;
+
+    void showMatchMenu();
+    void chooseMatchFiles(MatchEq::Target target);
+
+    void updateCompareButtons();
+
+    void bindChannel(int channel);
+    void updateEditChannelEnablement();
+
+    void updateDynamicControlsEnablement();
+
+    // dải chỉnh band: một bộ control, gắn lại attachment khi chọn band khác
+    juce::ComboBox bandSelector, bandTypeBox;
+    juce::ToggleButton bandEnabledButton{ "Enabled" };
+
+    std::unique_ptr<Attachment> bandFreqSliderAttachment,
+                                bandGainSliderAttachment,
+                                bandQualitySliderAttachment;
+    std::unique_ptr<ButtonAttachment> bandEnabledButtonAttachment;
+    std::unique_ptr<APVTS::ComboBoxAttachment> bandTypeBoxAttachment;
+
+    void selectBand(int band);
 
     std::vector<juce::Component*> getComps();
 
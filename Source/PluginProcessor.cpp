@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "MatchEq.h"
 
 //==============================================================================
 AudioPluginBetaAudioProcessor::AudioPluginBetaAudioProcessor()
@@ -16,18 +17,36 @@ AudioPluginBetaAudioProcessor::AudioPluginBetaAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        )
 #endif
 {
+    for (int i = 0; i < snapshotPoolSize; ++i)
+        snapshotPool.add(new CoefficientSnapshot());
+
+    presetParameters = getPresetParameters(*this);
+    presetBank = PresetBank::getShared(apvts, presetParameters);
+
+    meteringEnabled = apvts.getRawParameterValue("Metering");
+    autoGainEnabled = apvts.getRawParameterValue("Auto Gain");
+    analyzerExportEnabled = apvts.getRawParameterValue("Analyzer Export");
 }
 
 AudioPluginBetaAudioProcessor::~AudioPluginBetaAudioProcessor()
 {
 }
 
+MatchEq& AudioPluginBetaAudioProcessor::getMatchEq()
+{
+    if (matchEq == nullptr)
+        matchEq = std::make_unique<MatchEq>();
+
+    return *matchEq;
+}
+
 //==============================================================================
 const juce::String AudioPluginBetaAudioProcessor::getName() const
 {
@@ -68,26 +87,57 @@ double AudioPluginBetaAudioProcessor::getTailLengthSeconds() const
 
 int AudioPluginBetaAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    // NB: some hosts don't cope very well if you tell them there are 0 programs,
+    // so this should be at least 1, even if you're not really implementing programs.
+    return presetBank != nullptr ? juce::jmax(1, presetBank->getNumPresets()) : 1;
 }
 
 int AudioPluginBetaAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void AudioPluginBetaAudioProcessor::setCurrentProgram (int index)
 {
+    if (presetBank == nullptr || !juce::isPositiveAndBelow(index, presetBank->getNumPresets()))
+        return;
+
+    // nạp preset báo host qua setValueNotifyingHost: host gọi từ thread khác thì để message thread nạp
+    if (juce::MessageManager::existsAndIsCurrentThread()) {
+        applyProgram(index);
+        return;
+    }
+
+    pendingProgram = index;
+    triggerAsyncUpdate();
+}
+
+void AudioPluginBetaAudioProcessor::handleAsyncUpdate()
+{
+    auto index = pendingProgram.exchange(-1);
+    if (index >= 0)
+        applyProgram(index);
+}
+
+void AudioPluginBetaAudioProcessor::applyProgram(int index)
+{
+    // đọc thẳng record trong vùng map vào các param EQ, không cấp phát; audio thread đi dần
+    // tới giá trị mới trong block kế tiếp (nội suy hệ số), đổi preset khi đang phát không click
+    writeParametersAsOneUnit([&] {
+        if (presetBank->apply(index, presetParameters))
+            currentProgram = index;
+    });
 }
 
 const juce::String AudioPluginBetaAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return presetBank != nullptr ? presetBank->getName(index) : juce::String();
 }
 
 void AudioPluginBetaAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    if (presetBank != nullptr)
+        presetBank->rename(index, newName);
 }
 
 //==============================================================================
@@ -104,14 +154,53 @@ void AudioPluginBetaAudioProcessor::prepareToPlay (double sampleRate, int sample
     spec.numChannels = 1;                       // mono có 1 channel
     spec.sampleRate = sampleRate;           
 
-    // pass to chain
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    // pass to chain: cả 2 engine, host có thể đổi độ chính xác trước mỗi lần prepare
+    floatEngine.prepare(spec);
+    doubleEngine.prepare(spec);
+
+    for (auto& dynamicPeak : dynamicPeaks)
+        dynamicPeak.prepare(sampleRate);
+
+    // đuôi phải im lặng liên tục ~100 ms (vài chu kỳ của tần số thấp nhất) mới vào idle
+    idleHoldSamples = juce::roundToInt(sampleRate * 0.1);
+    silentSamples = 0;
+    idle = false;
+
+    // bắt đầu ngay ở trạng thái bypass hiện tại, không fade khi vừa prepare
+    auto bypassed = apvts.getRawParameterValue("Bypass")->load() > 0.5f;
+    auto numChannels = getTotalNumOutputChannels();
+    floatEngine.bypass.prepare(sampleRate, samplesPerBlock, numChannels);
+    floatEngine.bypass.reset(bypassed);
+    doubleEngine.bypass.prepare(sampleRate, samplesPerBlock, numChannels);
+    doubleEngine.bypass.reset(bypassed);
+
+    // bảng dựng 1 lần cho mỗi sample rate, instance khác cùng rate dùng lại
+    auto table = PrewarpTable::getForSampleRate(sampleRate);
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        std::swap(prewarpTable, table);
+    }
 
     updateFilters();
 
-    leftChannelFifo.prepare(samplesPerBlock);
-    rightChannelFifo.prepare(samplesPerBlock);
+    prepareAutoGain(sampleRate);
+    updateAutoGain();
+
+    // K-weighting + bộ nội suy true peak theo sample rate mới, số đo bắt đầu lại
+    loudnessMeter.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+
+    // fifo analyzer chỉ có khi editor đang cần
+    analyzerBlockSize = samplesPerBlock;
+    analyzerSampleRate = sampleRate;
+    analyzerInput.setSize(juce::jmax(2, getTotalNumInputChannels()), samplesPerBlock, false, true, true);
+    analyzerInputSamples = 0;
+    AnalyzerFifos::Ptr fifos;
+    {
+        const juce::SpinLock::ScopedLockType lock(analyzerLock);
+        fifos = analyzer;
+    }
+    if (fifos != nullptr)
+        fifos->prepare(samplesPerBlock, sampleRate, getLatencySamples());
 
     osc.initialise([](float x) { return std::sin(x); });
 
@@ -145,6 +234,16 @@ bool AudioPluginBetaAudioProcessor::isBusesLayoutSupported (const BusesLayout& l
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // sidechain cho dynamic EQ: tắt, mono hoặc stereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sidechain = layouts.getChannelSet(true, 1);
+        if (! sidechain.isDisabled()
+         && sidechain != juce::AudioChannelSet::mono()
+         && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -153,6 +252,17 @@ bool AudioPluginBetaAudioProcessor::isBusesLayoutSupported (const BusesLayout& l
 #endif
 
 void AudioPluginBetaAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void AudioPluginBetaAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -167,10 +277,62 @@ void AudioPluginBetaAudioProcessor::processBlock (juce::AudioBuffer<float>& buff
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    updateFilters();
+    // tap trước EQ: chụp input trước khi chain ghi đè buffer
+    captureAnalyzerInput(buffer);
+
+    // param đọc 1 lần mỗi block; nếu freq / gain / Q đổi thì đi dần từ giá trị block
+    // trước tới giá trị mới theo từng sub-block, không nhảy bậc ở biên block
+    readParameters();
+
+    // target theo snapshot mà chain đang chạy, tầng cuối tự trượt tới đó
+    updateAutoGain();
+
+    auto& engine = getEngine<SampleType>();
+    const auto& globalSettings = targetSettings[0];
+
+    auto wasBypassed = engine.bypass.isFullyBypassed();
+    engine.bypass.setFadeLength(globalSettings.bypassFadeMs);
+    engine.bypass.setBypassed(globalSettings.bypassed);
+
+    if (engine.bypass.isFullyBypassed()) {
+        // không chạy DSP, chỉ theo kịp param (không đổi thì chỉ là phép so sánh)
+        currentSettings = targetSettings;
+        renderFilters(1.f);
+
+        if (globalSettings.bypassWarmState)
+            warmUpChains(buffer);
+
+        feedAnalyzer(buffer);
+        meterOutput(buffer);
+        return;
+    }
+
+    // trạng thái lọc đứng yên từ lúc bypass đã lỗi thời: bắt đầu lại từ 0, fade-in che phần quá độ
+    if (wasBypassed && !globalSettings.bypassWarmState)
+        engine.reset();
+
+    auto fading = engine.bypass.isFading();
+
+    // có tín hiệu là thức dậy ngay trong block này (trạng thái đã về 0 lúc vào idle)
+    const auto numChannels = juce::jmin(2, buffer.getNumChannels());
+    auto inputSilent = isBelowSilenceThreshold(buffer, numChannels);
+    if (!inputSilent) {
+        silentSamples = 0;
+        idle = false;
+    }
 
+    if (idle && !fading) {
+        // không lọc, không nạp analyzer: buffer vẫn là input (dưới -120 dBFS)
+        currentSettings = targetSettings;
+        renderFilters(1.f);
+
+        // meter chỉ đẩy đồng hồ (block dưới cổng -70 LUFS không tính vào integrated)
+        if (isMeteringEnabled())
+            loudnessMeter.processSilence(buffer.getNumSamples());
+        return;
+    }
     // tạo 1 block để extract channel (left, right) từ cái buffer
-    juce::dsp::AudioBlock<float> block(buffer);
+    juce::dsp::AudioBlock<SampleType> block(buffer);
 
     //buffer.clear();
 
@@ -181,21 +343,328 @@ void AudioPluginBetaAudioProcessor::processBlock (juce::AudioBuffer<float>& buff
     //juce::dsp::ProcessContextReplacing<float> stereoContext(block);
     //osc.process(stereoContext);
 
+    const auto numSamples = buffer.getNumSamples();
+
+    auto gliding = hasContinuousChanges(currentSettings[0], targetSettings[0])
+        || hasContinuousChanges(currentSettings[1], targetSettings[1]);
+
+    // không có gì để nội suy: cả block một lượt như trước
+    if (!gliding)
+        renderFilters(1.f);
+
+    // nội suy: từng parameterInterval; đang fade: bộ đệm dry chỉ dài bằng block lúc prepare,
+    // block dài hơn của host được chia đoạn (lưu dry, lọc, trộn từng đoạn)
+    auto chunkSize = gliding ? parameterInterval : numSamples;
+    if (fading)
+        chunkSize = juce::jmin(chunkSize, engine.bypass.getMaximumChunkSize());
+
+    for (int start = 0; start < numSamples; start += chunkSize) {
+        auto num = juce::jmin(chunkSize, numSamples - start);
+
+        // hệ số của sub-block lấy theo vị trí cuối sub-block
+        if (gliding)
+            renderFilters((float)(start + num) / (float)numSamples);
+
+        if (fading)
+            engine.bypass.storeDry(buffer, start, num);
+
+        auto subBlock = block.getSubBlock((size_t)start, (size_t)num);
+        processRange(subBlock, buffer, start);
+
+        if (fading)
+            engine.bypass.mixDry(buffer, start, num);
+    }
+
+    currentSettings = targetSettings;
+
+    // input im lặng: chờ tới khi output (đuôi của bộ lọc) cũng tắt hẳn đủ lâu
+    if (inputSilent && !fading) {
+        if (isBelowSilenceThreshold(buffer, numChannels)) {
+            silentSamples += numSamples;
+            if (silentSamples >= idleHoldSamples)
+                enterIdle(engine);
+        }
+        else {
+            silentSamples = 0;
+        }
+    }
+
+    // trong quá trình xử lý khối thì cần update liên tục
+    feedAnalyzer(buffer);
+    meterOutput(buffer);
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::meterOutput(const juce::AudioBuffer<SampleType>& buffer) {
+    if (isMeteringEnabled())
+        loudnessMeter.process(buffer);
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::captureAnalyzerInput(const juce::AudioBuffer<SampleType>& buffer) {
+    const auto numSamples = buffer.getNumSamples();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), analyzerInput.getNumChannels());
+
+    // không có editor nào cần analyzer: khỏi copy. analyzerActive chỉ đọc ở đây, 1 lần mỗi block:
+    // block nào được chụp thì cả 4 tap nhận block đó, không chụp thì không tap nào nhận.
+    // block lớn hơn lúc prepare (không cấp phát trên audio thread) cũng bỏ cả 4 tap, tap trước / sau không lệch nhau
+    analyzerInputSamples = 0;
+    if (!analyzerActive || numSamples == 0 || numSamples > analyzerInput.getNumSamples())
+        return;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto* source = buffer.getReadPointer(channel);
+        auto* destination = analyzerInput.getWritePointer(channel);
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = (float)source[i];
+    }
+
+    analyzerInputSamples = numSamples;
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::feedAnalyzer(const juce::AudioBuffer<SampleType>& buffer) {
+    // block không được chụp (analyzer tắt / vừa bật giữa block / block quá lớn): không tap nào nhận
+    if (analyzerInputSamples == 0 || analyzerInputSamples != buffer.getNumSamples())
+        return;
+
+    // bản chụp chỉ dài đúng block này
+    juce::AudioBuffer<float> input(analyzerInput.getArrayOfWritePointers(), analyzerInput.getNumChannels(), analyzerInputSamples);
+
+    // không chờ, không bao giờ nhả tham chiếu cuối ở đây: giải phóng luôn nằm trên message thread
+    const juce::SpinLock::ScopedTryLockType lock(analyzerLock);
+    if (lock.isLocked() && analyzer != nullptr && analyzer->isPrepared())
+        analyzer->update(input, buffer);
+}
+
+template<typename SampleType>
+bool AudioPluginBetaAudioProcessor::isBelowSilenceThreshold(const juce::AudioBuffer<SampleType>& buffer, int numChannels) {
+    // getMagnitude dùng findMinAndMax (SIMD) của JUCE
+    for (int channel = 0; channel < numChannels; ++channel)
+        if (buffer.getMagnitude(channel, 0, buffer.getNumSamples()) > (SampleType)silenceThreshold)
+            return false;
+
+    return true;
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::enterIdle(EqEngine<SampleType>& engine) {
+    // phần dư dưới ngưỡng bỏ đi, lúc thức dậy chain bắt đầu từ trạng thái sạch
+    engine.reset();
+    for (auto& dynamicPeak : dynamicPeaks)
+        dynamicPeak.reset();
+
+    idle = true;
+    silentSamples = 0;
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::processRange(juce::dsp::AudioBlock<SampleType>& block,
+    juce::AudioBuffer<SampleType>& buffer, int startSample) {
+    if (dynamicPeakActive[0] || dynamicPeakActive[1])
+        processDynamicPeak(block, buffer, startSample);
+    else
+        processChains(block);
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::warmUpChains(const juce::AudioBuffer<SampleType>& buffer) {
+    auto& bypass = getEngine<SampleType>().bypass;
+    auto& scratch = bypass.getScratchBuffer();
+    juce::dsp::AudioBlock<SampleType> block(scratch);
+
+    // cả block (bản copy, từng đoạn bằng bộ đệm): trạng thái lọc liền mạch với tín hiệu,
+    // tốn CPU như khi không bypass
+    const auto numSamples = buffer.getNumSamples();
+    const auto chunkSize = bypass.getMaximumChunkSize();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), scratch.getNumChannels());
+
+    for (int start = 0; start < numSamples; start += chunkSize) {
+        auto num = juce::jmin(chunkSize, numSamples - start);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            scratch.copyFrom(channel, 0, buffer, channel, start, num);
+
+        auto subBlock = block.getSubBlock(0, (size_t)num);
+        processChains(subBlock);
+    }
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::processChains(juce::dsp::AudioBlock<SampleType>& block) {
+    if (stereoMode == StereoMode::MidSide) {
+        processMidSide(block);
+        return;
+    }
+
+    processChannels(block);
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::processChannels(juce::dsp::AudioBlock<SampleType>& block) {
+    auto& engine = getEngine<SampleType>();
+
+    if (topology == FilterTopology::StateVariable) {
+        const auto numSamples = (int)block.getNumSamples();
+        engine.svfChains[0].process(block.getChannelPointer(0), numSamples);
+        engine.svfChains[1].process(block.getChannelPointer(1), numSamples);
+        return;
+    }
+
     // tạo các block đại diện cho các kênh
     auto leftBlock = block.getSingleChannelBlock(0);
     auto rightBlock = block.getSingleChannelBlock(1);
 
     // tạo 1 context để chứa 2 con kênh kia
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    juce::dsp::ProcessContextReplacing<SampleType> leftContext(leftBlock);
+    juce::dsp::ProcessContextReplacing<SampleType> rightContext(rightBlock);
 
     // thêm mấy cái context vừa tạo vào mono filter chain
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    engine.leftChain.process(leftContext);
+    engine.rightChain.process(rightContext);
+}
 
-    // trong quá trình xử lý khối thì cần update liên tục
-    leftChannelFifo.update(buffer);
-    rightChannelFifo.update(buffer);
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::processMidSide(juce::dsp::AudioBlock<SampleType>& block) {
+    auto& engine = getEngine<SampleType>();
+    auto* left = block.getChannelPointer(0);
+    auto* right = block.getChannelPointer(1);
+    const auto numSamples = (int)block.getNumSamples();
+
+    // SVF: cả chain là một vòng lặp từng sample, 2 chain chạy chung vòng lặp đó cùng encode / decode
+    if (topology == FilterTopology::StateVariable) {
+        SvfChain<SampleType>::processMidSide(engine.svfChains[0], engine.svfChains[1], left, right, numSamples);
+        return;
+    }
+
+    // biquad: các tầng chạy theo block như L/R. Tầng biquad đầu tiên đang bật của chain mid đọc thẳng L/R
+    // (encode trong vòng lặp của nó, side chưa lọc sang kênh 1), chain side chạy trọn trên kênh 1,
+    // rồi tầng band của chain mid decode ngay lúc ghi ra
+    auto& midChain = engine.leftChain;
+    auto midBlock = block.getSingleChannelBlock(0);
+    juce::dsp::ProcessContextReplacing<SampleType> midContext(midBlock);
+
+    auto encoded = false;
+    auto processSection = [&](FilterType<SampleType>& section) {
+        if (encoded) {
+            section.process(midContext);
+            return;
+        }
+
+        section.processEncodingMidSide(left, right, numSamples);
+        encoded = true;
+    };
+
+    auto processCut = [&](CutFilterType<SampleType>& cut) {
+        if (!cut.template isBypassed<0>())
+            processSection(cut.template get<0>());
+        if (!cut.template isBypassed<1>())
+            processSection(cut.template get<1>());
+        if (!cut.template isBypassed<2>())
+            processSection(cut.template get<2>());
+        if (!cut.template isBypassed<3>())
+            processSection(cut.template get<3>());
+    };
+
+    if (!midChain.template isBypassed<ChainPositions::lowCut>())
+        processCut(midChain.template get<ChainPositions::lowCut>());
+    if (!midChain.template isBypassed<ChainPositions::Peak>())
+        processSection(midChain.template get<ChainPositions::Peak>());
+    if (!midChain.template isBypassed<ChainPositions::HighCut>())
+        processCut(midChain.template get<ChainPositions::HighCut>());
+
+    // chain mid chỉ còn các band (cut / peak đều tắt): không có tầng nào trước đó để gộp, encode riêng
+    if (!encoded) {
+        for (int i = 0; i < numSamples; ++i) {
+            auto l = left[i], r = right[i];
+            left[i] = (SampleType)0.5 * (l + r);
+            right[i] = (SampleType)0.5 * (l - r);
+        }
+    }
+
+    auto sideBlock = block.getSingleChannelBlock(1);
+    juce::dsp::ProcessContextReplacing<SampleType> sideContext(sideBlock);
+    engine.rightChain.process(sideContext);
+
+    jassert(!midChain.template isBypassed<ChainPositions::Bands>());
+    midChain.template get<ChainPositions::Bands>().processSamplesDecodingMidSide(left, right, numSamples);
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::processDynamicPeak(juce::dsp::AudioBlock<SampleType>& block,
+    juce::AudioBuffer<SampleType>& buffer, int startSample)
+{
+    auto& engine = getEngine<SampleType>();
+
+    // detector nghe input (trước khi lọc) hoặc bus sidechain nếu host nối vào,
+    // block là đoạn bắt đầu từ startSample của buffer. Bus chính mono: kênh 1 của buffer
+    // là của sidechain (hoặc không có), cả 2 phía đều nghe kênh 0
+    auto mainInput = getBusBuffer(buffer, true, 0);
+    const SampleType* inputLeft = mainInput.getReadPointer(0, startSample);
+    const SampleType* inputRight = mainInput.getNumChannels() > 1 ? mainInput.getReadPointer(1, startSample) : inputLeft;
+    const SampleType* sidechainLeft = nullptr;
+    const SampleType* sidechainRight = nullptr;
+
+    auto* sidechainBus = getBus(true, 1);
+    if (sidechainBus != nullptr && sidechainBus->isEnabled()) {
+        auto sidechain = getBusBuffer(buffer, true, 1);
+        if (sidechain.getNumChannels() > 0) {
+            sidechainLeft = sidechain.getReadPointer(0, startSample);
+            sidechainRight = sidechain.getNumChannels() > 1 ? sidechain.getReadPointer(1, startSample) : sidechainLeft;
+        }
+    }
+
+    const auto numSamples = (int)block.getNumSamples();
+
+    // chia block thành các sub-block, mỗi sub-block: chạy detector trên input
+    // chưa lọc, lấy hệ số từ bảng rồi mới lọc sub-block đó
+    for (int start = 0; start < numSamples; start += DynamicPeakBand::controlInterval) {
+        auto num = juce::jmin(DynamicPeakBand::controlInterval, numSamples - start);
+
+        for (int channel = 0; channel < 2; ++channel) {
+            if (!dynamicPeakActive[channel])
+                continue;
+
+            auto useSidechain = dynamicPeakUsesSidechain[channel] && sidechainLeft != nullptr;
+            auto* left = (useSidechain ? sidechainLeft : inputLeft) + start;
+            auto* right = (useSidechain ? sidechainRight : inputRight) + start;
+
+            // linked: detector mono; L/R: mỗi kênh nghe kênh của nó; M/S: nghe mid hoặc side
+            float gain = 0.f;
+            switch (stereoMode) {
+            case StereoMode::LeftRight:
+                gain = dynamicPeaks[channel].processDetector(channel == 0 ? left : right, (const SampleType*)nullptr, num);
+                break;
+            case StereoMode::MidSide:
+                gain = dynamicPeaks[channel].processDetector(left, right, num, channel == 1);
+                break;
+            case StereoMode::Linked:
+            default:
+                gain = dynamicPeaks[channel].processDetector(left, right, num);
+                break;
+            }
+
+            if (topology == FilterTopology::StateVariable) {
+                // SVF: thiết kế thẳng tầng peak (g tra bảng), chain tự ramp từng sample tới đó
+                auto section = makeSvfPeak(getSampleRate(),
+                    dynamicPeaks[channel].getFrequency(),
+                    dynamicPeaks[channel].getQuality(),
+                    juce::Decibels::decibelsToGain(gain),
+                    useSweepCache ? prewarpTable.get() : nullptr);
+
+                engine.svfChains[channel].setSection(SvfPeakSlot, section);
+                if (stereoMode == StereoMode::Linked)
+                    engine.svfChains[1].setSection(SvfPeakSlot, section);
+                continue;
+            }
+
+            // linked: peak của cả 2 chain trỏ cùng object này nên ghi 1 lần là đủ
+            writeBiquad(*engine.dynamicPeakCoefficients[channel], dynamicPeaks[channel].getCoefficientsForGain(gain));
+        }
+
+        auto subBlock = block.getSubBlock((size_t)start, (size_t)num);
+        processChains(subBlock);
+    }
 }
 
 //==============================================================================
@@ -217,8 +686,8 @@ void AudioPluginBetaAudioProcessor::getStateInformation (juce::MemoryBlock& dest
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
     
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    // header + mảng giá trị param (PresetState.h), không serialise cả ValueTree
+    writeBinaryState(getParameters(), destData);
 }
 
 void AudioPluginBetaAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
@@ -226,91 +695,833 @@ void AudioPluginBetaAudioProcessor::setStateInformation (const void* data, int s
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
 
+    // đường nhanh: blob nhị phân, ghi thẳng vào param
+    // audio thread đọc param mới và tự thiết kế + publish ở block sau
+    if (isBinaryState(data, sizeInBytes)) {
+        writeParametersAsOneUnit([&] { readBinaryState(getParameters(), data, sizeInBytes); });
+        return;
+    }
+
+    // blob cũ (ValueTree) từ các bản trước
     // Có thể trích xuất dữ liệu trong treestate dùng help function
     // Việc cẩn làm là kiểm tra xem treestate có valid trước khi copy không
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid()) {
-        apvts.replaceState(tree);
-        updateFilters();
+    if (tree.isValid())
+        writeParametersAsOneUnit([&] { apvts.replaceState(tree); });
+
+
+}
+
+juce::AudioProcessorParameter* AudioPluginBetaAudioProcessor::getBypassParameter() const
+{
+    return apvts.getParameter("Bypass");
+}
+
+juce::StringArray getStereoModeNames() {
+    return { "Linked", "Left / Right", "Mid / Side" };
+}
+
+juce::StringArray getFilterTopologyNames() {
+    return { "Biquad", "SVF" };
+}
+
+juce::String getChannelParameterPrefix(int channel) {
+    // kênh đầu (linked / trái / mid) giữ tên param gốc để tương thích preset cũ
+    return channel == 0 ? juce::String() : juce::String("B ");
+}
+
+juce::Array<juce::AudioProcessorParameter*> getPresetParameters(const juce::AudioProcessor& processor) {
+    // tên (không tiền tố) của các param từng kênh: addFilterParameters + addDynamicPeakParameters + addBandParameters
+    static const auto channelNames = [] {
+        juce::StringArray names{
+            "LowCut Freq", "HighCut Freq", "Peak Freq", "Peak Gain", "Peak Quality",
+            "LowCut Slope", "HighCut Slope", "LowCut Bypassed", "Peak Bypassed", "HighCut Bypassed",
+            "Peak Dynamic", "Peak Sidechain", "Peak Threshold", "Peak Ratio", "Peak Attack", "Peak Release" };
+
+        for (int i = 0; i < MaxParametricBands; ++i)
+            for (auto* name : { "Enabled", "Type", "Freq", "Gain", "Quality" })
+                names.add(getBandParameterID(i, name));
+
+        return names;
+    }();
+
+    const auto secondPrefix = getChannelParameterPrefix(1);
+
+    juce::Array<juce::AudioProcessorParameter*> parameters;
+    for (auto* parameter : processor.getParameters()) {
+        auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter);
+        if (withID == nullptr)
+            continue;
+
+        auto id = withID->paramID;
+        if (id == "Stereo Mode" || id == "Analog Matched") {
+            parameters.add(parameter);
+            continue;
+        }
+
+        if (id.startsWith(secondPrefix))
+            id = id.substring(secondPrefix.length());
+
+        if (channelNames.contains(id))
+            parameters.add(parameter);
     }
 
+    return parameters;
+}
 
+ChainParameters::ChainParameters(juce::AudioProcessorValueTreeState& apvts, const juce::String& prefix) {
+    auto get = [&apvts](const juce::String& parameterID) {
+        auto* parameter = apvts.getRawParameterValue(parameterID);
+        jassert(parameter != nullptr);
+        return parameter;
+    };
+
+    lowCutFreq = get(prefix + "LowCut Freq");
+    highCutFreq = get(prefix + "HighCut Freq");
+    peakFreq = get(prefix + "Peak Freq");
+    peakGain = get(prefix + "Peak Gain");
+    peakQuality = get(prefix + "Peak Quality");
+    lowCutSlope = get(prefix + "LowCut Slope");
+    highCutSlope = get(prefix + "HighCut Slope");
+
+    lowCutBypassed = get(prefix + "LowCut Bypassed");
+    peakBypassed = get(prefix + "Peak Bypassed");
+    highCutBypassed = get(prefix + "HighCut Bypassed");
+
+    // các tuỳ chọn chung, không có bản riêng theo kênh
+    analogMatched = get("Analog Matched");
+    sweepCache = get("Sweep Cache");
+    stereoMode = get("Stereo Mode");
+    topology = get("Filter Topology");
+    bypassed = get("Bypass");
+    bypassFade = get("Bypass Fade");
+    bypassWarmState = get("Bypass Warm State");
+
+    peakDynamic = get(prefix + "Peak Dynamic");
+    peakSidechain = get(prefix + "Peak Sidechain");
+    peakThreshold = get(prefix + "Peak Threshold");
+    peakRatio = get(prefix + "Peak Ratio");
+    peakAttack = get(prefix + "Peak Attack");
+    peakRelease = get(prefix + "Peak Release");
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        auto& band = bands[i];
+        band.enabled = get(prefix + getBandParameterID(i, "Enabled"));
+        band.type = get(prefix + getBandParameterID(i, "Type"));
+        band.freq = get(prefix + getBandParameterID(i, "Freq"));
+        band.gain = get(prefix + getBandParameterID(i, "Gain"));
+        band.quality = get(prefix + getBandParameterID(i, "Quality"));
+    }
 }
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts) {
+ChainSettings ChainParameters::read() const {
     ChainSettings settings;
 
-    // tạo 1 đối tượng settings và thiết lập thông số bằng
-    // GetRaw -> load() để đảm bảo đơn vị
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-    settings.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-    settings.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
-    settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
-
-    settings.lowCutBypassed = apvts.getRawParameterValue("LowCut Bypassed")->load() > 0.5f;
-    settings.peakBypassed = apvts.getRawParameterValue("Peak Bypassed")->load() > 0.5f;
-    settings.highCutBypassed = apvts.getRawParameterValue("HighCut Bypassed")->load() > 0.5f;
-    
+    // load() trả về đúng đơn vị của param (Hz, dB, ms...)
+    settings.lowCutFreq = lowCutFreq->load();
+    settings.highCutFreq = highCutFreq->load();
+    settings.peakFreq = peakFreq->load();
+    settings.peakGainInDecibels = peakGain->load();
+    settings.peakQuality = peakQuality->load();
+    settings.lowCutSlope = static_cast<Slope>(lowCutSlope->load());
+    settings.highCutSlope = static_cast<Slope>(highCutSlope->load());
+
+    settings.lowCutBypassed = lowCutBypassed->load() > 0.5f;
+    settings.peakBypassed = peakBypassed->load() > 0.5f;
+    settings.highCutBypassed = highCutBypassed->load() > 0.5f;
+
+    settings.analogMatched = analogMatched->load() > 0.5f;
+    settings.sweepCache = sweepCache->load() > 0.5f;
+    settings.stereoMode = static_cast<StereoMode>(stereoMode->load());
+    settings.topology = static_cast<FilterTopology>(topology->load());
+    settings.bypassed = bypassed->load() > 0.5f;
+    settings.bypassFadeMs = bypassFade->load();
+    settings.bypassWarmState = bypassWarmState->load() > 0.5f;
+
+    settings.peakDynamic = peakDynamic->load() > 0.5f;
+    settings.peakUseSidechain = peakSidechain->load() > 0.5f;
+    settings.peakThreshold = peakThreshold->load();
+    settings.peakRatio = peakRatio->load();
+    settings.peakAttackMs = peakAttack->load();
+    settings.peakReleaseMs = peakRelease->load();
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        auto& band = settings.bands[i];
+        band.enabled = bands[i].enabled->load() > 0.5f;
+        band.type = static_cast<BandType>(bands[i].type->load());
+        band.freq = bands[i].freq->load();
+        band.gainInDecibels = bands[i].gain->load();
+        band.quality = bands[i].quality->load();
+    }
+
     return settings;
 }
 
-Coefficents makePeakFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate,
-        chainSettings.peakFreq,
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts, const juce::String& prefix) {
+    return ChainParameters(apvts, prefix).read();
+}
+
+namespace
+{
+    // freq đi theo log (đều theo octave), gain (dB) và Q tuyến tính
+    float interpolateFrequency(float from, float to, float proportion) {
+        if (from == to || from <= 0.f || to <= 0.f)
+            return to;
+        return from * std::pow(to / from, proportion);
+    }
+
+    float interpolateLinear(float from, float to, float proportion) {
+        return from == to ? to : from + (to - from) * proportion;
+    }
+}
+
+ChainSettings interpolateChainSettings(const ChainSettings& from, const ChainSettings& to, float proportion) {
+    if (proportion >= 1.f)
+        return to;
+
+    auto settings = to;
+
+    settings.peakFreq = interpolateFrequency(from.peakFreq, to.peakFreq, proportion);
+    settings.peakGainInDecibels = interpolateLinear(from.peakGainInDecibels, to.peakGainInDecibels, proportion);
+    settings.peakQuality = interpolateLinear(from.peakQuality, to.peakQuality, proportion);
+    settings.lowCutFreq = interpolateFrequency(from.lowCutFreq, to.lowCutFreq, proportion);
+    settings.highCutFreq = interpolateFrequency(from.highCutFreq, to.highCutFreq, proportion);
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        auto& band = settings.bands[i];
+        band.freq = interpolateFrequency(from.bands[i].freq, to.bands[i].freq, proportion);
+        band.gainInDecibels = interpolateLinear(from.bands[i].gainInDecibels, to.bands[i].gainInDecibels, proportion);
+        band.quality = interpolateLinear(from.bands[i].quality, to.bands[i].quality, proportion);
+    }
+
+    return settings;
+}
+
+bool hasContinuousChanges(const ChainSettings& from, const ChainSettings& to) {
+    if (from.peakFreq != to.peakFreq
+        || from.peakGainInDecibels != to.peakGainInDecibels
+        || from.peakQuality != to.peakQuality
+        || from.lowCutFreq != to.lowCutFreq
+        || from.highCutFreq != to.highCutFreq)
+        return true;
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        const auto& a = from.bands[i];
+        const auto& b = to.bands[i];
+        if (a.freq != b.freq || a.gainInDecibels != b.gainInDecibels || a.quality != b.quality)
+            return true;
+    }
+
+    return false;
+}
+
+void AudioPluginBetaAudioProcessor::updateDynamicPeak(const ChainSettings& chainSettings, int channel) {
+    auto& dynamicPeak = dynamicPeaks[channel];
+
+    // bảng hệ số chỉ dựng lại khi freq/Q đổi, hệ số thật được ghi đè theo control rate
+    dynamicPeakActive[channel] = chainSettings.peakDynamic && !chainSettings.peakBypassed;
+    dynamicPeakUsesSidechain[channel] = chainSettings.peakUseSidechain;
+
+    dynamicPeak.setBand(chainSettings.peakFreq,
         chainSettings.peakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+        chainSettings.peakGainInDecibels,
+        chainSettings.analogMatched);
+    dynamicPeak.setDynamics(chainSettings.peakThreshold,
+        chainSettings.peakRatio,
+        chainSettings.peakAttackMs,
+        chainSettings.peakReleaseMs);
+}
+
+bool CoefficientSnapshot::matches(const ChainSettings& other, double otherSampleRate, bool otherDoublePrecision) const {
+    if (sampleRate != otherSampleRate || doublePrecision != otherDoublePrecision)
+        return false;
+
+    const auto& s = settings;
+    if (s.peakFreq != other.peakFreq
+        || s.peakGainInDecibels != other.peakGainInDecibels
+        || s.peakQuality != other.peakQuality
+        || s.lowCutFreq != other.lowCutFreq
+        || s.highCutFreq != other.highCutFreq
+        || s.lowCutSlope != other.lowCutSlope
+        || s.highCutSlope != other.highCutSlope
+        || s.lowCutBypassed != other.lowCutBypassed
+        || s.highCutBypassed != other.highCutBypassed
+        || s.peakBypassed != other.peakBypassed
+        || s.analogMatched != other.analogMatched
+        || s.sweepCache != other.sweepCache
+        || s.peakDynamic != other.peakDynamic
+        || s.stereoMode != other.stereoMode
+        || s.topology != other.topology)
+        return false;
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        const auto& band = s.bands[i];
+        const auto& otherBand = other.bands[i];
+        if (band.enabled != otherBand.enabled
+            || band.type != otherBand.type
+            || band.freq != otherBand.freq
+            || band.gainInDecibels != otherBand.gainInDecibels
+            || band.quality != otherBand.quality)
+            return false;
+    }
+
+    return true;
+}
+
+double CoefficientSnapshot::getMagnitudeForFrequency(double frequency) const {
+    double mag = 1.0;
+
+    if (!settings.peakBypassed)
+        mag *= peak->getMagnitudeForFrequency(frequency, sampleRate);
+
+    // chỉ các tầng đang dùng theo slope, các tầng sau là dữ liệu cũ
+    if (!settings.lowCutBypassed)
+        for (int i = 0; i <= settings.lowCutSlope; ++i)
+            mag *= lowCut.getUnchecked(i)->getMagnitudeForFrequency(frequency, sampleRate);
+
+    if (!settings.highCutBypassed)
+        for (int i = 0; i <= settings.highCutSlope; ++i)
+            mag *= highCut.getUnchecked(i)->getMagnitudeForFrequency(frequency, sampleRate);
+
+    for (int i = 0; i < MaxParametricBands; ++i)
+        if (bands.active[i])
+            mag *= ::getMagnitudeForFrequency(bands.coefficients[i], frequency, sampleRate);
+
+    return mag;
+}
+
+CoefficientSnapshot::CoefficientSnapshot()
+    : peak(new juce::dsp::IIR::Coefficients<float>(1.f, 0.f, 0.f, 1.f, 0.f, 0.f)),
+      lowCut(makeBiquadStorage(MaxCutSections)),
+      highCut(makeBiquadStorage(MaxCutSections)),
+      peakDouble(new juce::dsp::IIR::Coefficients<double>(1.0, 0.0, 0.0, 1.0, 0.0, 0.0)),
+      lowCutDouble(makeBiquadStorage<double>(MaxCutSections)),
+      highCutDouble(makeBiquadStorage<double>(MaxCutSections))
+{
 }
 
-void AudioPluginBetaAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings) {
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+void CoefficientSnapshot::design(const ChainSettings& chainSettings, double newSampleRate, juce::uint32 newVersion,
+    const PrewarpTable* prewarpTable, bool withDoublePrecision) {
+    settings = chainSettings;
+    sampleRate = newSampleRate;
+    version = newVersion;
+    doublePrecision = withDoublePrecision;
+
+    if (!chainSettings.sweepCache || (prewarpTable != nullptr && prewarpTable->getSampleRate() != sampleRate))
+        prewarpTable = nullptr;
+
+    // SVF chỉ có bản bilinear
+    auto designSettings = chainSettings;
+    if (designSettings.topology == FilterTopology::StateVariable)
+        designSettings.analogMatched = false;
+
+    auto peakGain = juce::Decibels::decibelsToGain(designSettings.peakGainInDecibels);
+
+    // hệ số Peak tĩnh, ghi vào object có sẵn
+    auto peakCoefficients = designPeakBiquad(sampleRate,
+        designSettings.peakFreq,
+        designSettings.peakQuality,
+        peakGain,
+        designSettings.analogMatched,
+        prewarpTable);
+    writeBiquad(*peak, peakCoefficients);
+
+    designLowCutFilter(lowCut, designSettings, sampleRate, prewarpTable);
+    designHighCutFilter(highCut, designSettings, sampleRate, prewarpTable);
+
+    if (doublePrecision) {
+        writeBiquad(*peakDouble, peakCoefficients);
+        designLowCutFilter(lowCutDouble, designSettings, sampleRate, prewarpTable);
+        designHighCutFilter(highCutDouble, designSettings, sampleRate, prewarpTable);
+    }
+
+    bands = makeParametricBands(designSettings.bands, sampleRate, designSettings.analogMatched);
+
+    if (designSettings.topology != FilterTopology::StateVariable)
+        return;
 
-    leftChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-    rightChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+    // cùng các nguyên mẫu analog, bypass = tầng không active
+    svf.active.fill(false);
 
-    updateCoefficents(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficents(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    if (!designSettings.lowCutBypassed) {
+        auto order = 2 * (designSettings.lowCutSlope + 1);
+        makeSvfHighPassCascade(&svf.sections[SvfLowCutSlot], designSettings.lowCutFreq, sampleRate, order, prewarpTable);
+        for (int i = 0; i < order / 2; ++i)
+            svf.active[SvfLowCutSlot + i] = true;
+    }
+
+    if (!designSettings.peakBypassed) {
+        svf.sections[SvfPeakSlot] = makeSvfPeak(sampleRate, designSettings.peakFreq, designSettings.peakQuality, peakGain, prewarpTable);
+        svf.active[SvfPeakSlot] = true;
+    }
+
+    if (!designSettings.highCutBypassed) {
+        auto order = 2 * (designSettings.highCutSlope + 1);
+        makeSvfLowPassCascade(&svf.sections[SvfHighCutSlot], designSettings.highCutFreq, sampleRate, order, prewarpTable);
+        for (int i = 0; i < order / 2; ++i)
+            svf.active[SvfHighCutSlot + i] = true;
+    }
+
+    for (int i = 0; i < MaxParametricBands; ++i) {
+        const auto& band = designSettings.bands[i];
+        svf.active[SvfBandSlot + i] = band.enabled;
+        if (band.enabled)
+            svf.sections[SvfBandSlot + i] = makeSvfBand(band, sampleRate, prewarpTable);
+    }
 }
 
-void updateCoefficents(Coefficents& old, const Coefficents& replacements) {
-    *old = *replacements;
+CoefficientSnapshot::Ptr AudioPluginBetaAudioProcessor::getCoefficientSnapshot(int channel) const {
+    const juce::SpinLock::ScopedLockType lock(snapshotLock);
+    return snapshots[channel];
 }
 
-void AudioPluginBetaAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings) {
-    auto cutCoefficents = makeLowCutFilter(chainSettings, getSampleRate());
-    // lọc ở loa trái + phải
-    auto& leftLowCut = leftChain.get<ChainPositions::lowCut>();
-    auto& rightLowCut = rightChain.get<ChainPositions::lowCut>();
+AnalyzerFifos::Ptr AudioPluginBetaAudioProcessor::acquireAnalyzer() {
+    // chỉ message thread ghi analyzer, đọc ở đây không cần lock
+    if (analyzer != nullptr)
+        return analyzer;
 
-    leftChain.setBypassed<ChainPositions::lowCut>(chainSettings.lowCutBypassed);
-    rightChain.setBypassed<ChainPositions::lowCut>(chainSettings.lowCutBypassed);
+    AnalyzerFifos::Ptr fifos = new AnalyzerFifos();
+    if (auto blockSize = analyzerBlockSize.load(); blockSize > 0)
+        fifos->prepare(blockSize, analyzerSampleRate, getLatencySamples());
 
-    updateCutFilter(leftLowCut, cutCoefficents, chainSettings.lowCutSlope);
-    updateCutFilter(rightLowCut, cutCoefficents, chainSettings.lowCutSlope);  
+    const juce::SpinLock::ScopedLockType lock(analyzerLock);
+    analyzer = fifos;
+    analyzerActive = true;
+    return analyzer;
 }
 
-void AudioPluginBetaAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings) {
-    auto highCutCoefficents = makeHighCutFilter(chainSettings, getSampleRate());
-    // lọc thông thấp ở loa trái + phải
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
+void AudioPluginBetaAudioProcessor::releaseAnalyzer(AnalyzerFifos::Ptr& fifos) {
+    fifos = nullptr;
 
-    leftChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-    rightChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+    if (analyzer == nullptr || analyzer->getReferenceCount() > 1)
+        return;
 
-    updateCutFilter(leftHighCut, highCutCoefficents, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficents, chainSettings.highCutSlope);    
+    // giải phóng ngoài lock, audio thread chỉ bỏ qua analyzer trong lúc đổi con trỏ
+    AnalyzerFifos::Ptr previous;
+    {
+        const juce::SpinLock::ScopedLockType lock(analyzerLock);
+        previous = analyzer;
+        analyzer = nullptr;
+        analyzerActive = false;
+    }
+}
+
+AudioPluginBetaAudioProcessor::MemoryUsage AudioPluginBetaAudioProcessor::getMemoryUsage() const {
+    MemoryUsage usage;
+
+    usage.engines = sizeof(floatEngine) + sizeof(doubleEngine)
+        + floatEngine.bypass.getMemoryUsage() + doubleEngine.bypass.getMemoryUsage();
+
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        usage.snapshots = (size_t)snapshotPool.size() * sizeof(CoefficientSnapshot);
+    }
+
+    for (const auto& state : compareStates)
+        usage.snapshots += state.getSize();
+
+    AnalyzerFifos::Ptr fifos;
+    {
+        const juce::SpinLock::ScopedLockType lock(analyzerLock);
+        fifos = analyzer;
+    }
+    if (fifos != nullptr)
+        usage.analyzer = fifos->getMemoryUsage();
+
+    return usage;
+}
+
+void AudioPluginBetaAudioProcessor::selectCompareSlot(int slot) {
+    if (!juce::isPositiveAndBelow(slot, numCompareSlots) || slot == activeCompareSlot)
+        return;
+
+    // slot đang rời giữ giá trị các param EQ, tuỳ chọn chung không thuộc slot nào
+    auto& previous = compareStates[activeCompareSlot];
+    writeBinaryState(presetParameters, previous);
+
+    auto& next = compareStates[slot];
+    activeCompareSlot = slot;
+
+    // lần đầu mở slot: bắt đầu từ bản sao của slot kia
+    if (next.isEmpty()) {
+        next = previous;
+        return;
+    }
+
+    // audio thread chỉ thấy trọn bộ param của slot mới, thiết kế + publish ở block sau
+    auto loaded = false;
+    writeParametersAsOneUnit([&] { loaded = readBinaryState(presetParameters, next.getData(), (int)next.getSize()); });
+    if (!loaded)
+        return;
+
+    // báo sau khi ghi xong: block đọc được bộ mới nhảy thẳng tới đó, không glide từ slot cũ
+    snapToTarget = true;
+}
+
+void AudioPluginBetaAudioProcessor::applyMatchedSettings(const ChainSettings& settings, int channel) {
+    const auto prefix = getChannelParameterPrefix(channel);
+
+    // mỗi param một gesture như khi người dùng kéo, host ghi được automation
+    auto setParameter = [this, &prefix](const juce::String& name, float value) {
+        if (auto* param = apvts.getParameter(prefix + name)) {
+            param->beginChangeGesture();
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+            param->endChangeGesture();
+        }
+    };
+
+    writeParametersAsOneUnit([&] {
+        // cut bị fit tắt: tần số / slope là giá trị thử vô nghĩa, giữ nguyên của người dùng
+        setParameter("LowCut Bypassed", settings.lowCutBypassed ? 1.f : 0.f);
+        if (!settings.lowCutBypassed) {
+            setParameter("LowCut Freq", settings.lowCutFreq);
+            setParameter("LowCut Slope", (float)settings.lowCutSlope);
+        }
+
+        setParameter("HighCut Bypassed", settings.highCutBypassed ? 1.f : 0.f);
+        if (!settings.highCutBypassed) {
+            setParameter("HighCut Freq", settings.highCutFreq);
+            setParameter("HighCut Slope", (float)settings.highCutSlope);
+        }
+
+        setParameter("Peak Bypassed", settings.peakBypassed ? 1.f : 0.f);
+        setParameter("Peak Freq", settings.peakFreq);
+        setParameter("Peak Gain", settings.peakGainInDecibels);
+        setParameter("Peak Quality", settings.peakQuality);
+    });
+}
+
+template<typename Function>
+void AudioPluginBetaAudioProcessor::writeParametersAsOneUnit(Function&& write) {
+    // chỉ message thread ghi nguyên bộ (preset / slot / state / match fit), không lồng nhau
+    jassert((parameterWriteSequence.load() & 1) == 0);
+
+    parameterWriteSequence.fetch_add(1, std::memory_order_acq_rel);
+    write();
+    parameterWriteSequence.fetch_add(1, std::memory_order_release);
+}
+
+CoefficientSnapshot::Ptr AudioPluginBetaAudioProcessor::acquireSnapshot() {
+    // chỉ pool còn giữ: không chain hay GUI nào đang dùng
+    const juce::SpinLock::ScopedLockType lock(snapshotLock);
+    for (auto* snapshot : snapshotPool)
+        if (snapshot->getReferenceCount() == 1)
+            return snapshot;
+
+    // không bao giờ cấp phát ở đây (audio thread)
+    jassertfalse;
+    return nullptr;
+}
+
+void AudioPluginBetaAudioProcessor::publishSnapshots(const ChainSettings& first, const ChainSettings* second) {
+    auto sampleRate = getSampleRate();
+
+    publishSnapshot(0, first, sampleRate);
+
+    if (second != nullptr) {
+        publishSnapshot(1, *second, sampleRate);
+        return;
+    }
+
+    // bản cũ được nhả ngoài lock
+    CoefficientSnapshot::Ptr previous;
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        previous = snapshots[1];
+        snapshots[1] = snapshots[0];
+    }
+}
+
+void AudioPluginBetaAudioProcessor::publishSnapshot(int channel, const ChainSettings& chainSettings, double sampleRate) {
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        if (snapshots[channel] != nullptr && snapshots[channel]->matches(chainSettings, sampleRate, isUsingDoublePrecision()))
+            return;
+    }
+
+    PrewarpTable::Ptr table;
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        table = prewarpTable;
+    }
+
+    // thiết kế ngoài lock, GUI vẫn đọc được bản cũ trong lúc này
+    auto snapshot = acquireSnapshot();
+    if (snapshot == nullptr)
+        return;
+
+    snapshot->design(chainSettings, sampleRate, ++snapshotVersion, table.get(), isUsingDoublePrecision());
+
+    CoefficientSnapshot::Ptr previous;
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        previous = snapshots[channel];
+        snapshots[channel] = snapshot;
+    }
+}
+
+void AudioPluginBetaAudioProcessor::applySnapshots() {
+    std::array<CoefficientSnapshot::Ptr, 2> latest;
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        latest = snapshots;
+    }
+
+    if (latest[0] == nullptr || latest[1] == nullptr)
+        return;
+
+    // bản thiết kế trước khi host đổi sang double chưa có hệ số double: đợi bản mới
+    auto doublePrecision = isUsingDoublePrecision();
+    if (doublePrecision && !(latest[0]->doublePrecision && latest[1]->doublePrecision))
+        return;
+
+    auto apply = [this, doublePrecision](const CoefficientSnapshot& snapshot, ChannelList channels, int dynamicChannel) {
+        if (doublePrecision)
+            applySnapshot<double>(snapshot, channels, dynamicChannel);
+        else
+            applySnapshot<float>(snapshot, channels, dynamicChannel);
+    };
+
+    // linked: cùng một snapshot, 2 chain trỏ vào cùng các object hệ số
+    if (latest[0] == latest[1]) {
+        if (latest != appliedSnapshots)
+            apply(*latest[0], { 0, 1 }, 0);
+    }
+    else {
+        if (latest[0] != appliedSnapshots[0])
+            apply(*latest[0], { 0 }, 0);
+        if (latest[1] != appliedSnapshots[1])
+            apply(*latest[1], { 1 }, 1);
+    }
+
+    // giữ tham chiếu để object hệ số còn sống khi chain đang dùng
+    appliedSnapshots = latest;
+}
+
+template<typename SampleType>
+void AudioPluginBetaAudioProcessor::applySnapshot(const CoefficientSnapshot& snapshot, ChannelList channels, int dynamicChannel) {
+    const auto& chainSettings = snapshot.settings;
+    auto& engine = getEngine<SampleType>();
+
+    if (chainSettings.topology == FilterTopology::StateVariable) {
+        // peak động: setParameters đặt gain tĩnh, processDynamicPeak ghi đè theo control rate
+        for (auto channel : channels)
+            engine.svfChains[channel].setParameters(snapshot.svf);
+        return;
+    }
+
+    // peak động ghi hệ số theo control rate vào object riêng của kênh
+    auto peakCoefficients = chainSettings.peakDynamic && !chainSettings.peakBypassed
+        ? engine.dynamicPeakCoefficients[dynamicChannel]
+        : snapshot.getPeak<SampleType>();
+
+    for (auto channel : channels) {
+        auto& chain = engine.getMonoChain(channel);
+
+        chain.template setBypassed<ChainPositions::lowCut>(chainSettings.lowCutBypassed);
+        updateCutFilter(chain.template get<ChainPositions::lowCut>(), snapshot.getLowCut<SampleType>(), chainSettings.lowCutSlope);
+
+        chain.template setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+        chain.template get<ChainPositions::Peak>().coefficients = peakCoefficients;
+
+        chain.template setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+        updateCutFilter(chain.template get<ChainPositions::HighCut>(), snapshot.getHighCut<SampleType>(), chainSettings.highCutSlope);
+
+        chain.template get<ChainPositions::Bands>().setCoefficients(snapshot.bands);
+    }
+}
+
+void AudioPluginBetaAudioProcessor::prepareAutoGain(double sampleRate) {
+    // 20 Hz .. 20 kHz (dưới 0.45 fs), mỗi điểm là một dải log bằng nhau
+    auto maxFrequency = juce::jmin(20000.0, sampleRate * 0.45);
+    auto sum = 0.0;
+
+    for (int i = 0; i < autoGainPoints; ++i) {
+        auto frequency = 20.0 * std::pow(maxFrequency / 20.0, (i + 0.5) / autoGainPoints);
+        autoGainFrequencies[(size_t)i] = frequency;
+        autoGainWeights[(size_t)i] = LoudnessMeter::getWeightingPower(frequency, sampleRate);
+        sum += autoGainWeights[(size_t)i];
+    }
+
+    for (auto& weight : autoGainWeights)
+        weight /= sum;
+
+    // sample rate mới: snapshot nào cũng phải tính lại
+    autoGainVersions.fill(0);
+}
+
+double AudioPluginBetaAudioProcessor::computeAutoGain(const CoefficientSnapshot& snapshot) const {
+    auto power = 0.0;
+    for (int i = 0; i < autoGainPoints; ++i) {
+        auto magnitude = snapshot.getMagnitudeForFrequency(autoGainFrequencies[(size_t)i]);
+        power += autoGainWeights[(size_t)i] * magnitude * magnitude;
+    }
+
+    // bù tối đa +-24 dB (ví dụ cut gần như chặn hết dải)
+    return power > 0.0 ? juce::jlimit(1.0 / 16.0, 16.0, 1.0 / std::sqrt(power)) : 1.0;
+}
+
+void AudioPluginBetaAudioProcessor::updateAutoGain() {
+    auto enabled = autoGainEnabled->load() > 0.5f;
+
+    for (int channel = 0; channel < 2; ++channel) {
+        const auto& snapshot = appliedSnapshots[channel];
+        if (snapshot == nullptr)
+            continue;
+
+        // linked: kênh 2 chung snapshot, khỏi tính 2 lần
+        auto version = enabled ? snapshot->version : 0;
+        if (version == autoGainVersions[channel])
+            continue;
+
+        auto gain = 1.0;
+        if (channel == 1 && version != 0 && appliedSnapshots[0] == snapshot)
+            gain = autoGains[0];
+        else if (enabled)
+            gain = computeAutoGain(*snapshot);
+
+        autoGainVersions[channel] = version;
+        autoGains[channel] = gain;
+        autoGainDecibels[channel].store((float)juce::Decibels::gainToDecibels(gain), std::memory_order_relaxed);
+
+        floatEngine.setOutputGain(channel, (float)gain);
+        doubleEngine.setOutputGain(channel, gain);
+    }
 }
 
 void AudioPluginBetaAudioProcessor::updateFilters() {
-    auto chainSettings = getChainSettings(apvts);
+    // không nội suy: nhảy thẳng tới param hiện tại (prepareToPlay)
+    readParameters();
+    currentSettings = targetSettings;
+    renderFilters(1.f);
+}
+
+void AudioPluginBetaAudioProcessor::readParameters() {
+    // preset / slot A/B đang ghi dở: giữ target cũ, block sau đọc lại trọn bộ
+    const auto sequence = parameterWriteSequence.load(std::memory_order_acquire);
+    if ((sequence & 1) != 0)
+        return;
+
+    auto chainSettings = chainParameters[0].read();
+    auto secondSettings = chainParameters[1].read();
 
-    updateLowCutFilters(chainSettings);
-    updatePeakFilter(chainSettings);
-    updateHighCutFilters(chainSettings);
+    // lấy cờ trước khi kiểm tra: cờ đặt sau một lần ghi thì lần ghi đó làm số đổi, cờ được trả lại
+    auto snap = snapToTarget.exchange(false);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (parameterWriteSequence.load(std::memory_order_relaxed) != sequence) {
+        if (snap)
+            snapToTarget = true;
+        return;
+    }
+
+    // đổi chế độ stereo thì trạng thái lọc cũ không còn đúng nghĩa (L/R <-> M/S)
+    auto modeChanged = chainSettings.stereoMode != stereoMode || chainSettings.topology != topology;
+    if (modeChanged) {
+        floatEngine.reset();
+        doubleEngine.reset();
+
+        stereoMode = chainSettings.stereoMode;
+        topology = chainSettings.topology;
+    }
+
+    useSweepCache = chainSettings.sweepCache;
+
+    targetSettings[0] = chainSettings;
+
+    // bảng hệ số của peak động dựng theo giá trị đích, 1 lần mỗi block
+    if (stereoMode == StereoMode::Linked) {
+        targetSettings[1] = chainSettings;
+        updateDynamicPeak(chainSettings, 0);
+        dynamicPeakActive[1] = false;
+    }
+    else {
+        // L/R hoặc M/S: kênh thứ 2 (phải / side) có bộ param riêng
+        targetSettings[1] = secondSettings;
+        updateDynamicPeak(targetSettings[0], 0);
+        updateDynamicPeak(targetSettings[1], 1);
+    }
+
+    // kênh 2 vừa có nghĩa khác (hoặc vừa reset): không nội suy từ giá trị cũ
+    // đổi slot A/B: không glide từ slot cũ
+    if (snap || modeChanged)
+        currentSettings = targetSettings;
+}
+
+void AudioPluginBetaAudioProcessor::renderFilters(float proportion) {
+    auto first = interpolateChainSettings(currentSettings[0], targetSettings[0], proportion);
+
+    if (stereoMode == StereoMode::Linked) {
+        publishSnapshots(first, nullptr);
+    }
+    else {
+        auto second = interpolateChainSettings(currentSettings[1], targetSettings[1], proportion);
+        publishSnapshots(first, &second);
+    }
+
+    // chỉ thiết kế lại khi giá trị nội suy thật sự khác, gán vào chain khi có snapshot mới
+    applySnapshots();
+}
+
+namespace
+{
+    // lowcut / highcut / peak của một kênh
+    void addFilterParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, const juce::String& prefix)
+    {
+        // thêm lowcut param: Hz
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "LowCut Freq", prefix + "LowCut Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20.f));
+        // thêm highcut param: Hz
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "HighCut Freq", prefix + "HighCut Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20000.f));
+        // thêm peak param: Hz
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Freq", prefix + "Peak Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 750.f));
+        // thêm peak gain param: dB
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Gain", prefix + "Peak Gain", juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.0f));
+        // thêm peak quality param: narrow or wide
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Quality", prefix + "Peak Quality", juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f));
+
+        // lọc thông 12dB/oct, 24dB/oct, 36dB/oct, 48dB/oct
+        juce::StringArray stringArray;
+        for (int i = 0; i < 4; i++) {
+            juce::String str;
+            str << (12 + i * 12);
+            str << ("dB/Oct");
+            stringArray.add(str);
+        }
+
+        // tạo choice cho chế độ lọc thông
+        layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + "LowCut Slope", prefix + "LowCut Slope", stringArray, 0));
+        layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + "HighCut Slope", prefix + "HighCut Slope", stringArray, 0));
+
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "LowCut Bypassed", prefix + "LowCut Bypassed", false));
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "Peak Bypassed", prefix + "Peak Bypassed", false));
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "HighCut Bypassed", prefix + "HighCut Bypassed", false));
+    }
+
+    // dynamic EQ cho band Peak: gain tĩnh bị kéo xuống khi mức trong dải vượt threshold
+    void addDynamicPeakParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, const juce::String& prefix)
+    {
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "Peak Dynamic", prefix + "Peak Dynamic", false));
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "Peak Sidechain", prefix + "Peak Sidechain", false));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Threshold", prefix + "Peak Threshold", juce::NormalisableRange<float>(-60.f, 0.f, 0.5f, 1.f), -20.f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Ratio", prefix + "Peak Ratio", juce::NormalisableRange<float>(1.f, 10.f, 0.1f, 0.5f), 2.f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Attack", prefix + "Peak Attack", juce::NormalisableRange<float>(1.f, 100.f, 1.f, 0.5f), 10.f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Release", prefix + "Peak Release", juce::NormalisableRange<float>(5.f, 500.f, 1.f, 0.5f), 100.f));
+    }
+
+    // các band tham số, mặc định tắt và rải đều trên thang log
+    void addBandParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, const juce::String& prefix)
+    {
+        const std::array<float, MaxParametricBands> defaultBandFreqs{ 60.f, 150.f, 400.f, 1000.f, 2500.f, 5000.f, 8000.f, 12000.f };
+        for (int i = 0; i < MaxParametricBands; ++i) {
+            auto id = [i, &prefix](const juce::String& name) { return prefix + getBandParameterID(i, name); };
+
+            layout.add(std::make_unique<juce::AudioParameterBool>(id("Enabled"), id("Enabled"), false));
+            layout.add(std::make_unique<juce::AudioParameterChoice>(id("Type"), id("Type"), getBandTypeNames(), 0));
+            layout.add(std::make_unique<juce::AudioParameterFloat>(id("Freq"), id("Freq"), juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), defaultBandFreqs[i]));
+            layout.add(std::make_unique<juce::AudioParameterFloat>(id("Gain"), id("Gain"), juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.0f));
+            layout.add(std::make_unique<juce::AudioParameterFloat>(id("Quality"), id("Quality"), juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f));
+        }
+    }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
@@ -318,36 +1529,44 @@ juce::AudioProcessorValueTreeState::ParameterLayout
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-    // thêm lowcut param: Hz
-    layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut Freq", "LowCut Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20.f));
-    // thêm highcut param: Hz
-    layout.add(std::make_unique<juce::AudioParameterFloat>("HighCut Freq", "HighCut Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20000.f));
-    // thêm peak param: Hz
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Freq", "Peak Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 750.f));
-    // thêm peak gain param: dB
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Gain", "Peak Gain", juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.0f));
-    // thêm peak quality param: narrow or wide
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Quality", "Peak Quality", juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f));
-    
-    // lọc thông 12dB/oct, 24dB/oct, 36dB/oct, 48dB/oct
-    juce::StringArray stringArray;
-    for (int i = 0; i < 4; i++) {
-        juce::String str;
-        str << (12 + i * 12);
-        str << ("dB/Oct");
-        stringArray.add(str);
-    }
-
-    // tạo choice cho chế độ lọc thông
-    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", stringArray, 0));
-    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", stringArray, 0));
-
-    layout.add(std::make_unique<juce::AudioParameterBool>("LowCut Bypassed", "LowCut Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("Peak Bypassed", "Peak Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("HighCut Bypassed", "HighCut Bypassed", false));
+    // giữ nguyên thứ tự param cũ, các param mới luôn thêm vào sau
+    addFilterParameters(layout, getChannelParameterPrefix(0));
+
     layout.add(std::make_unique<juce::AudioParameterBool>("Analyzer Enabled", "Analyzer Enabled", true));
 
-    
+    // thiết kế matched: chính xác ở tần số cao mà không cần oversampling
+    layout.add(std::make_unique<juce::AudioParameterBool>("Analog Matched", "Analog Matched", false));
+
+    addDynamicPeakParameters(layout, getChannelParameterPrefix(0));
+    addBandParameters(layout, getChannelParameterPrefix(0));
+
+    // linked: 2 kênh dùng chung param; L/R và M/S: kênh thứ 2 dùng bộ param "B ..."
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Stereo Mode", "Stereo Mode", getStereoModeNames(), 0));
+
+    addFilterParameters(layout, getChannelParameterPrefix(1));
+    addDynamicPeakParameters(layout, getChannelParameterPrefix(1));
+    addBandParameters(layout, getChannelParameterPrefix(1));
+
+    // tan() của cut / peak lấy từ bảng nội suy (sai số < 1e-4 trên tần số cắt)
+    layout.add(std::make_unique<juce::AudioParameterBool>("Sweep Cache", "Sweep Cache", true));
+
+    // backend lọc: biquad trực tiếp hoặc SVF (ramp hệ số từng sample)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Filter Topology", "Filter Topology", getFilterTopologyNames(), 0));
+
+    // bypass cả plugin: crossfade equal-power dài "Bypass Fade" ms, bypass hẳn thì không chạy DSP
+    layout.add(std::make_unique<juce::AudioParameterBool>("Bypass", "Bypass", false));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Bypass Fade", "Bypass Fade", juce::NormalisableRange<float>(0.f, 200.f, 1.f, 0.5f), 20.f));
+    // vẫn chạy chain (trên bản copy) khi bypass, bật lại không bắt đầu từ trạng thái rỗng
+    layout.add(std::make_unique<juce::AudioParameterBool>("Bypass Warm State", "Bypass Warm State", false));
+
+    // loudness EBU R128 + true peak trên output
+    layout.add(std::make_unique<juce::AudioParameterBool>("Metering", "Metering", true));
+
+    // bù mức theo đáp ứng của EQ (K-weighted), so sánh A/B ở cùng độ to
+    layout.add(std::make_unique<juce::AudioParameterBool>("Auto Gain", "Auto Gain", false));
+
+    // xuất phổ + loudness của analyzer ra POSIX shared memory (xem AnalyzerExportLayout.h)
+    layout.add(std::make_unique<juce::AudioParameterBool>("Analyzer Export", "Analyzer Export", false));
 
     return layout;
 }
@@ -12,10 +12,64 @@
 
 #include <array>
 
+#include "FilterDesign.h"
+#include "DynamicEQ.h"
+#include "ParametricBands.h"
+#include "SvfFilter.h"
+#include "BypassFader.h"
+#include "BiquadFilter.h"
+#include "PresetState.h"
+#include "PresetBank.h"
+#include "LoudnessMeter.h"
+#include "AnalyzerExport.h"
+
+class MatchEq;
+
+// GUI đọc analyzer với nhịp này (timer của ResponseCurveComponent)
+constexpr int analyzerFrameRate = 60;
+
+/*
+số phần tử fifo cần để chứa các block (blockSize sample) dồn lại giữa hai lần GUI đọc,
+nhân framesOfSlack khung hình cho lúc GUI bị chậm: 48 kHz / 512 sample ~ 2 block / khung.
+*/
+inline int getFifoCapacityFor(double sampleRate, int blockSize, double frameRate, int framesOfSlack = 4)
+{
+    if (sampleRate <= 0 || blockSize <= 0 || frameRate <= 0)
+        return 30;
+
+    auto blocksPerFrame = sampleRate / ((double)blockSize * frameRate);
+    return juce::jlimit(4, 1024, (int)std::ceil(blocksPerFrame * framesOfSlack));
+}
+
 // GUI thread dùng cái này để lấy (dữ liệu từ) Block SCSF tạo ra
 template<typename T>
 struct Fifo
 {
+    explicit Fifo(int capacity = 30)
+    {
+        setCapacity(capacity);
+    }
+
+    /*
+    số phần tử giữ được cùng lúc. Cấp lại bộ nhớ: chỉ gọi khi bên ghi / đọc chưa chạy
+    (prepare), sau đó gọi lại prepare(...) để cấp từng phần tử.
+    */
+    void setCapacity(int newCapacity)
+    {
+        newCapacity = juce::jmax(2, newCapacity);
+        if (newCapacity == getCapacity())
+            return;
+
+        // AbstractFifo bỏ trống 1 ô để phân biệt đầy / rỗng
+        buffers.resize((size_t)newCapacity + 1);
+        fifo.setTotalSize(newCapacity + 1);
+    }
+
+    int getCapacity() const { return fifo.getTotalSize() - 1; }
+
+    // bỏ mọi phần tử đang chờ (không gọi khi bên ghi / đọc đang chạy)
+    void reset() { fifo.reset(); }
+
     void prepare(int numChannels, int numSamples)
     {
         static_assert(std::is_same_v<T, juce::AudioBuffer<float>>,
@@ -47,10 +101,12 @@ struct Fifo
         auto write = fifo.write(1);
         if (write.blockSize1 > 0)
         {
-            buffers[write.startIndex1] = t;
+            buffers[(size_t)write.startIndex1] = t;
             return true;
         }
 
+        // đầy: bên đọc không theo kịp, phần tử bị bỏ
+        overflows.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
 
@@ -59,10 +115,11 @@ struct Fifo
         auto read = fifo.read(1);
         if (read.blockSize1 > 0)
         {
-            t = buffers[read.startIndex1];
+            t = buffers[(size_t)read.startIndex1];
             return true;
         }
 
+        underflows.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
 
@@ -70,10 +127,33 @@ struct Fifo
     {
         return fifo.getNumReady();
     }
+
+    // đếm từ lúc tạo / resetCounters, đọc được từ thread bất kỳ
+    juce::uint32 getNumOverflows() const { return overflows.load(std::memory_order_relaxed); }
+    juce::uint32 getNumUnderflows() const { return underflows.load(std::memory_order_relaxed); }
+
+    void resetCounters()
+    {
+        overflows = 0;
+        underflows = 0;
+    }
+
+    // dữ liệu của các phần tử đã cấp (byte)
+    size_t getMemoryUsage() const
+    {
+        size_t bytes = sizeof(*this);
+        for (const auto& buffer : buffers) {
+            if constexpr (std::is_same_v<T, juce::AudioBuffer<float>>)
+                bytes += (size_t)(buffer.getNumChannels() * buffer.getNumSamples()) * sizeof(float);
+            else if constexpr (std::is_same_v<T, std::vector<float>>)
+                bytes += buffer.capacity() * sizeof(float);
+        }
+        return bytes;
+    }
 private:
-    static constexpr int Capacity = 30;
-    std::array<T, Capacity> buffers;
-    juce::AbstractFifo fifo{ Capacity };
+    std::vector<T> buffers;
+    juce::AbstractFifo fifo{ 1 };
+    std::atomic<juce::uint32> overflows{ 0 }, underflows{ 0 };
 };
 
 
@@ -91,7 +171,9 @@ struct SingleChannelSampleFifo
         prepared.set(false);
     }
 
-    void update(const BlockType& buffer)
+    // buffer float hoặc double (host xử lý 64-bit), analyzer luôn nhận float
+    template<typename BufferType>
+    void update(const BufferType& buffer)
     {
         jassert(prepared.get());
         jassert(buffer.getNumChannels() > channelToUse);
@@ -99,15 +181,21 @@ struct SingleChannelSampleFifo
 
         for (int i = 0; i < buffer.getNumSamples(); ++i)
         {
-            pushNextSampleIntoFifo(channelPtr[i]);
+            pushNextSampleIntoFifo((float)channelPtr[i]);
         }
     }
 
-    void prepare(int bufferSize)
+    // số block trong fifo theo lượng block GUI phải đọc mỗi khung hình
+    // delaySamples: chèn trước chừng ấy sample 0, cả luồng sau đó trễ đúng delaySamples
+    void prepare(int bufferSize, double sampleRate, int delaySamples = 0)
     {
         prepared.set(false);
         size.set(bufferSize);
 
+        audioBufferFifo.setCapacity(getFifoCapacityFor(sampleRate, bufferSize, analyzerFrameRate));
+        audioBufferFifo.reset();
+        audioBufferFifo.resetCounters();
+
         bufferToFill.setSize(1,             //channel
             bufferSize,    //num samples
             false,         //keepExistingContent
@@ -115,6 +203,9 @@ struct SingleChannelSampleFifo
             true);         //avoid reallocating
         audioBufferFifo.prepare(1, bufferSize);
         fifoIndex = 0;
+        for (int i = 0; i < delaySamples; ++i)
+            pushNextSampleIntoFifo(0.f);
+
         prepared.set(true);
     }
     //==============================================================================
@@ -123,6 +214,16 @@ struct SingleChannelSampleFifo
     int getSize() const { return size.get(); }
     //==============================================================================
     bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+
+    int getCapacity() const { return audioBufferFifo.getCapacity(); }
+    // block bị bỏ vì GUI chưa đọc kịp
+    juce::uint32 getNumDroppedBuffers() const { return audioBufferFifo.getNumOverflows(); }
+
+    size_t getMemoryUsage() const
+    {
+        return audioBufferFifo.getMemoryUsage()
+            + (size_t)(bufferToFill.getNumChannels() * bufferToFill.getNumSamples()) * sizeof(float);
+    }
 private:
     Channel channelToUse;
     int fifoIndex = 0;
@@ -135,9 +236,8 @@ private:
     {
         if (fifoIndex == bufferToFill.getNumSamples())
         {
-            auto ok = audioBufferFifo.push(bufferToFill);
-
-            juce::ignoreUnused(ok);
+            // đầy thì block bị bỏ, fifo tự đếm (getNumDroppedBuffers)
+            audioBufferFifo.push(bufferToFill);
 
             fifoIndex = 0;
         }
@@ -147,6 +247,60 @@ private:
     }
 };
 
+/*
+fifo analyzer: tap sau EQ (output) và tap trước EQ (input) của 2 kênh. Không còn là member
+cố định của processor: chỉ được cấp khi editor mở và analyzer bật (acquireAnalyzer), editor
+đóng / tắt analyzer thì trả lại, instance không có editor không giữ bộ đệm analyzer nào.
+Cả 4 tap luôn được nạp cùng lúc nên các block đi cùng nhịp; tap trước EQ trễ thêm đúng
+latency của processor để thẳng hàng từng sample với tap sau EQ.
+*/
+struct AnalyzerFifos : juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<AnalyzerFifos>;
+    using BlockType = juce::AudioBuffer<float>;
+
+    SingleChannelSampleFifo<BlockType> leftChannelFifo{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> rightChannelFifo{ Channel::Right };
+    SingleChannelSampleFifo<BlockType> preLeftChannelFifo{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> preRightChannelFifo{ Channel::Right };
+
+    void prepare(int bufferSize, double sampleRate, int latencySamples)
+    {
+        leftChannelFifo.prepare(bufferSize, sampleRate);
+        rightChannelFifo.prepare(bufferSize, sampleRate);
+        preLeftChannelFifo.prepare(bufferSize, sampleRate, latencySamples);
+        preRightChannelFifo.prepare(bufferSize, sampleRate, latencySamples);
+    }
+
+    bool isPrepared() const
+    {
+        return leftChannelFifo.isPrepared() && rightChannelFifo.isPrepared()
+            && preLeftChannelFifo.isPrepared() && preRightChannelFifo.isPrepared();
+    }
+
+    // input: bản chụp buffer trước khi xử lý, output: buffer sau xử lý (cùng số sample)
+    template<typename BufferType>
+    void update(const BlockType& input, const BufferType& output)
+    {
+        preLeftChannelFifo.update(input);
+        preRightChannelFifo.update(input);
+        leftChannelFifo.update(output);
+        rightChannelFifo.update(output);
+    }
+
+    juce::uint32 getNumDroppedBuffers() const
+    {
+        return leftChannelFifo.getNumDroppedBuffers() + rightChannelFifo.getNumDroppedBuffers()
+            + preLeftChannelFifo.getNumDroppedBuffers() + preRightChannelFifo.getNumDroppedBuffers();
+    }
+
+    size_t getMemoryUsage() const
+    {
+        return sizeof(*this) + leftChannelFifo.getMemoryUsage() + rightChannelFifo.getMemoryUsage()
+            + preLeftChannelFifo.getMemoryUsage() + preRightChannelFifo.getMemoryUsage();
+    }
+};
+
 enum Slope {
     Slope_12,
     Slope_24,
@@ -154,35 +308,114 @@ enum Slope {
     Slope_48
 };
 
+enum StereoMode {
+    Linked,     // 2 kênh dùng chung 1 bộ param
+    LeftRight,  // trái: param gốc, phải: param "B ..."
+    MidSide     // mid: param gốc, side: param "B ..."
+};
+
+juce::StringArray getStereoModeNames();
+
+enum FilterTopology {
+    Biquad,         // biquad TDF-II dạng trực tiếp (mặc định)
+    StateVariable   // TPT SVF, hệ số ramp từng sample, hợp với automation nhanh
+};
+
+juce::StringArray getFilterTopologyNames();
+
 struct ChainSettings {
     float peakFreq{ 0 }, peakGainInDecibels{ 0 }, peakQuality{ 1.f };
     float lowCutFreq{ 0 }, highCutFreq{ 0 };
     Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
     bool lowCutBypassed{ false }, highCutBypassed{ false }, peakBypassed{ false }, analyzerEnabled{ true };
+    // thiết kế matched (Vicanek) thay cho bilinear, giữ đáp ứng analog tới Nyquist
+    bool analogMatched{ false };
+    // cut + peak bilinear lấy tan() từ bảng dùng chung theo sample rate (quét tần số nhanh)
+    bool sweepCache{ true };
+
+    // dynamic EQ cho band Peak
+    bool peakDynamic{ false }, peakUseSidechain{ false };
+    float peakThreshold{ 0 }, peakRatio{ 1.f }, peakAttackMs{ 10.f }, peakReleaseMs{ 100.f };
+
+    // các band người dùng thêm vào (bell, shelf, notch, band-pass, tilt)
+    BandArraySettings bands;
+
+    StereoMode stereoMode{ StereoMode::Linked };
+    FilterTopology topology{ FilterTopology::Biquad };
+
+    // bypass cả plugin (host điều khiển qua getBypassParameter), không ảnh hưởng hệ số
+    bool bypassed{ false }, bypassWarmState{ false };
+    float bypassFadeMs{ 20.f };
 };
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
+// tiền tố param của kênh thứ 2 (phải / side), kênh đầu dùng tên gốc
+juce::String getChannelParameterPrefix(int channel);
+
+// param của đường cong EQ (cut / peak / peak động / band của 2 kênh, stereo mode, analog matched) theo thứ tự layout:
+// preset và slot A/B chỉ lưu / nạp các param này, tuỳ chọn chung (bypass, analyzer, metering, topology...) giữ nguyên
+juce::Array<juce::AudioProcessorParameter*> getPresetParameters(const juce::AudioProcessor& processor);
 
-using Filter = juce::dsp::IIR::Filter<float>;
+// con trỏ raw param của 1 kênh, lấy 1 lần: audio thread chỉ load() atomic, không dựng String / tra hash
+struct ChainParameters {
+    // các tuỳ chọn chung (analog matched, stereo mode) luôn trỏ vào param không có tiền tố
+    ChainParameters(juce::AudioProcessorValueTreeState& apvts, const juce::String& prefix);
 
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
+    ChainSettings read() const;
 
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+private:
+    using Parameter = std::atomic<float>*;
+
+    Parameter lowCutFreq, highCutFreq, peakFreq, peakGain, peakQuality, lowCutSlope, highCutSlope;
+    Parameter lowCutBypassed, peakBypassed, highCutBypassed;
+    Parameter analogMatched, sweepCache, stereoMode, topology, bypassed, bypassFade, bypassWarmState;
+    Parameter peakDynamic, peakSidechain, peakThreshold, peakRatio, peakAttack, peakRelease;
+
+    struct BandParameters {
+        Parameter enabled, type, freq, gain, quality;
+    };
+    std::array<BandParameters, MaxParametricBands> bands;
+};
+
+// các tuỳ chọn chung (analog matched, stereo mode) luôn đọc từ param không có tiền tố
+// (tra theo ID mỗi lần gọi: chỉ dùng ngoài audio thread)
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts, const juce::String& prefix = {});
+
+// param liên tục (freq theo log, gain dB / Q tuyến tính) ở vị trí proportion (0..1) giữa from và to,
+// param rời rạc (slope, bypass, kiểu band, chế độ...) lấy luôn của to
+ChainSettings interpolateChainSettings(const ChainSettings& from, const ChainSettings& to, float proportion);
+
+// true nếu có freq / gain / Q nào khác nhau, tức là cần nội suy trong block
+bool hasContinuousChanges(const ChainSettings& from, const ChainSettings& to);
+
+// mọi chain đều có bản float và double, double dùng khi host xử lý 64-bit
+template<typename SampleType>
+using FilterType = BiquadFilter<SampleType>;
+
+template<typename SampleType>
+using CutFilterType = juce::dsp::ProcessorChain<FilterType<SampleType>, FilterType<SampleType>,
+    FilterType<SampleType>, FilterType<SampleType>>;
+
+template<typename SampleType>
+using MonoChainType = juce::dsp::ProcessorChain<CutFilterType<SampleType>, FilterType<SampleType>,
+    CutFilterType<SampleType>, ParametricBands<SampleType>>;
+
+using Filter = FilterType<float>;
+using CutFilter = CutFilterType<float>;
+using MonoChain = MonoChainType<float>;
 
 enum ChainPositions {
     lowCut,
     Peak,
-    HighCut
+    HighCut,
+    Bands
 };
 
 using Coefficents = Filter::CoefficientsPtr;
-void updateCoefficents(Coefficents& old, const Coefficents& replacements);
-
-Coefficents makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
 
 template<int Index, typename ChainType, typename CoefficentType>
 void update(ChainType& chain, const CoefficentType& coefficents) {
-    updateCoefficents(chain.template get<Index>().coefficients, coefficents[Index]);
+    // chỉ gán con trỏ: các chain dùng chung object hệ số của snapshot, không copy
+    chain.template get<Index>().coefficients = coefficents[Index];
     chain.template setBypassed<Index>(false);
 }
 
@@ -210,22 +443,142 @@ void updateCutFilter(ChainType& chain,
     }
 }
 
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
+// ghi thẳng vào các tầng có sẵn (ít nhất MaxCutSections), không cấp phát
+template<typename SampleType>
+void designLowCutFilter(CoefficientsArrayType<SampleType>& sections, const ChainSettings& chainSettings, double sampleRate,
+    const PrewarpTable* prewarpTable = nullptr) {
+    designHighPassCascade(sections,
+        chainSettings.lowCutFreq,
         sampleRate,
-        2 * (chainSettings.lowCutSlope + 1));
+        2 * (chainSettings.lowCutSlope + 1),
+        chainSettings.analogMatched,
+        prewarpTable);
 }
 
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
+template<typename SampleType>
+void designHighCutFilter(CoefficientsArrayType<SampleType>& sections, const ChainSettings& chainSettings, double sampleRate,
+    const PrewarpTable* prewarpTable = nullptr) {
+    designLowPassCascade(sections,
+        chainSettings.highCutFreq,
         sampleRate,
-        2 * (chainSettings.highCutSlope + 1));
+        2 * (chainSettings.highCutSlope + 1),
+        chainSettings.analogMatched,
+        prewarpTable);
 }
 
+/*
+bộ hệ số đầy đủ của một chain, thiết kế 1 lần mỗi khi param đổi rồi dùng chung
+cho cả 2 kênh (linked) và cho GUI vẽ đường phản hồi. Không sửa sau khi đã publish,
+version tăng dần để bên đọc biết có bản mới.
+*/
+struct CoefficientSnapshot : juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<CoefficientSnapshot>;
+
+    // cấp sẵn hệ số peak + MaxCutSections tầng cho mỗi bộ cut, design() chỉ ghi đè
+    CoefficientSnapshot();
+
+    // chỉ gọi khi snapshot chưa publish (hoặc đã trả về pool),
+    // prewarpTable chỉ được dùng khi settings.sweepCache bật,
+    // withDoublePrecision: thiết kế thêm bản double của peak + cut (host xử lý 64-bit)
+    void design(const ChainSettings& chainSettings, double newSampleRate, juce::uint32 newVersion,
+        const PrewarpTable* prewarpTable, bool withDoublePrecision);
+
+    ChainSettings settings;
+    double sampleRate = 0.0;
+    juce::uint32 version = 0;
+    bool doublePrecision = false;
+
+    // bản float luôn có (GUI vẽ từ đây), bản double chỉ hợp lệ khi doublePrecision
+    Coefficents peak;
+    CoefficientsArray lowCut, highCut;
+    juce::dsp::IIR::Coefficients<double>::Ptr peakDouble;
+    CoefficientsArrayType<double> lowCutDouble, highCutDouble;
+    ParametricBandsCoefficients bands;
+
+    template<typename SampleType>
+    const typename juce::dsp::IIR::Coefficients<SampleType>::Ptr& getPeak() const {
+        if constexpr (std::is_same_v<SampleType, double>) return peakDouble; else return peak;
+    }
+
+    template<typename SampleType>
+    const CoefficientsArrayType<SampleType>& getLowCut() const {
+        if constexpr (std::is_same_v<SampleType, double>) return lowCutDouble; else return lowCut;
+    }
+
+    template<typename SampleType>
+    const CoefficientsArrayType<SampleType>& getHighCut() const {
+        if constexpr (std::is_same_v<SampleType, double>) return highCutDouble; else return highCut;
+    }
+
+    // chỉ thiết kế khi topology là SVF; lúc đó các biquad ở trên luôn là bản bilinear
+    // (SVF không có bản matched) để đường cong trên GUI khớp với thứ đang chạy
+    SvfChainParameters svf;
+
+    // chỉ so các param ảnh hưởng tới hệ số / bypass (threshold, ratio... thì không)
+    bool matches(const ChainSettings& other, double otherSampleRate, bool otherDoublePrecision) const;
+
+    // |H| của cả chain (tôn trọng bypass), peak động được vẽ theo gain tĩnh
+    double getMagnitudeForFrequency(double frequency) const;
+};
+
+// trạng thái xử lý của một độ chính xác, processor giữ một bản float và một bản double
+template<typename SampleType>
+struct EqEngine
+{
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+
+    MonoChainType<SampleType> leftChain, rightChain;
+
+    // backend SVF thay cho cả MonoChain khi topology là StateVariable
+    std::array<SvfChain<SampleType>, 2> svfChains;
+
+    // peak động cần hệ số riêng (ghi theo control rate), không đụng vào snapshot dùng chung
+    std::array<typename Coefficients::Ptr, 2> dynamicPeakCoefficients;
+
+    // crossfade khi bật / tắt bypass, giữ buffer khô theo đúng kiểu sample
+    BypassFader<SampleType> bypass;
+
+    EqEngine()
+    {
+        // khởi tạo thành bộ lọc đi thẳng
+        for (auto& coefficients : dynamicPeakCoefficients)
+            coefficients = new Coefficients(1, 0, 0, 1, 0, 0);
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        leftChain.prepare(spec);
+        rightChain.prepare(spec);
+
+        for (auto& svfChain : svfChains)
+            svfChain.prepare(spec.sampleRate);
+    }
+
+    void reset()
+    {
+        leftChain.reset();
+        rightChain.reset();
+
+        for (auto& svfChain : svfChains)
+            svfChain.reset();
+    }
+
+    MonoChainType<SampleType>& getMonoChain(int channel) { return channel == 0 ? leftChain : rightChain; }
+
+    // auto gain: tầng cuối của cả 2 backend nhận cùng target, đổi topology không bị nhảy mức
+    void setOutputGain(int channel, SampleType gain)
+    {
+        getMonoChain(channel).template get<ChainPositions::Bands>().setOutputGain(gain);
+        svfChains[channel].setOutputGain(gain);
+    }
+};
+
 //==============================================================================
 /**
 */
-class AudioPluginBetaAudioProcessor  : public juce::AudioProcessor
+class AudioPluginBetaAudioProcessor  : public juce::AudioProcessor,
+                                       private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -241,6 +594,13 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // chain chạy thẳng ở double, host 64-bit không phải chuyển buffer qua lại
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+
+    // host bypass đi qua param "Bypass" để processBlock tự crossfade thay vì cắt ngang
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -272,23 +632,225 @@ public:
     // Cần cung cấp một danh sách các Param (trên)
     juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", createParameterLayout()};
 
-    using BlockType = juce::AudioBuffer<float>;
-    // can duoc Prepared
-    // 2 kênh fifo
-    SingleChannelSampleFifo<BlockType> leftChannelFifo{ Channel::Left };
-    SingleChannelSampleFifo<BlockType> rightChannelFifo{ Channel::Right };
+    using BlockType = AnalyzerFifos::BlockType;
+
+    // fifo analyzer 2 kênh, cấp khi cần (message thread), đã prepare nếu processor đã prepare
+    AnalyzerFifos::Ptr acquireAnalyzer();
+    // nhả tham chiếu của editor; không còn ai dùng thì processor giải phóng luôn
+    void releaseAnalyzer(AnalyzerFifos::Ptr& fifos);
+
+    // bộ nhớ riêng của instance (byte), analyzer = 0 khi không có editor nào cần
+    struct MemoryUsage
+    {
+        size_t engines = 0, snapshots = 0, analyzer = 0;
+        size_t getTotal() const { return engines + snapshots + analyzer; }
+    };
+
+    MemoryUsage getMemoryUsage() const;
 
+    // bản mới nhất của kênh (linked: 2 kênh chung một bản), null nếu chưa có
+    CoefficientSnapshot::Ptr getCoefficientSnapshot(int channel) const;
+
+    // A/B compare: mỗi slot giữ giá trị các param EQ (getPresetParameters)
+    static constexpr int numCompareSlots = 2;
+    int getActiveCompareSlot() const { return activeCompareSlot; }
+
+    // lưu slot đang dùng rồi nạp slot kia (message thread); slot còn trống nhận bản sao hiện tại
+    void selectCompareSlot(int slot);
+
+    // loudness / true peak của output, audio thread publish mỗi 100 ms (param "Metering" tắt thì đứng yên)
+    LoudnessMeter::Readings getLoudnessReadings() const { return loudnessMeter.getReadings(); }
+    void resetLoudness() { loudnessMeter.requestReset(); }
+    bool isMeteringEnabled() const { return meteringEnabled->load() > 0.5f; }
+
+    // gain bù hiện tại của kênh (dB, 0 khi "Auto Gain" tắt)
+    float getAutoGainDecibels(int channel) const { return autoGainDecibels[channel].load(std::memory_order_relaxed); }
+
+    // ring shared memory cho tool ngoài, editor publish mỗi khung analyzer khi param "Analyzer Export" bật;
+    // processor giữ để tên segment không đổi khi mở lại editor (chỉ message thread)
+    AnalyzerExport& getAnalyzerExport() { return analyzerExport; }
+    bool isAnalyzerExportEnabled() const { return AnalyzerExport::isSupported() && analyzerExportEnabled->load() > 0.5f; }
+
+    // phổ capture + solver của match EQ, tạo ở lần dùng đầu tiên; processor giữ nên đóng editor
+    // không mất capture (chỉ message thread)
+    MatchEq& getMatchEq();
+
+    // ghi kết quả fit vào các param cut / peak của kênh (kênh lúc bắt đầu fit) như một lần ghi nguyên bộ:
+    // audio thread thấy trọn bộ cũ hoặc trọn bộ mới, không glide về nửa kết quả (chỉ message thread)
+    void applyMatchedSettings(const ChainSettings& settings, int channel);
 
 private:
-    MonoChain leftChain, rightChain;
+    EqEngine<float> floatEngine;
+    EqEngine<double> doubleEngine;
 
-    void updatePeakFilter(const ChainSettings& chainSettings);
-    
-    void updateLowCutFilters(const ChainSettings& chainSettings);
-    void updateHighCutFilters(const ChainSettings& chainSettings);
+    template<typename SampleType>
+    EqEngine<SampleType>& getEngine() {
+        if constexpr (std::is_same_v<SampleType, double>) return doubleEngine; else return floatEngine;
+    }
+
+    FilterTopology topology = FilterTopology::Biquad;
+
+    // các kênh nhận chung một bộ hệ số (linked: cả 2 kênh)
+    using ChannelList = std::initializer_list<int>;
+
+    // snapshot đã publish và snapshot đang nằm trong chain của từng kênh
+    std::array<CoefficientSnapshot::Ptr, 2> snapshots, appliedSnapshots;
+    mutable juce::SpinLock snapshotLock;
+    std::atomic<juce::uint32> snapshotVersion{ 0 };
+
+    /*
+    snapshot được dùng lại khi không còn ai giữ (chỉ pool giữ), cấp hết trong constructor.
+    Số người giữ tối đa cùng lúc: 2 bản publish + 2 bản trong chain + GUI (2 + 1 đang đổi)
+    + 1 bản audio thread đang thiết kế.
+    */
+    static constexpr int snapshotPoolSize = 2 + 2 + 3 + 1;
+    juce::ReferenceCountedArray<CoefficientSnapshot> snapshotPool;
+    // null khi pool cạn: không publish, chain giữ bản hiện tại và block sau thử lại
+    CoefficientSnapshot::Ptr acquireSnapshot();
+
+    // bảng tan() dùng chung giữa các instance cùng sample rate, đổi trong prepareToPlay (giữ bởi snapshotLock)
+    PrewarpTable::Ptr prewarpTable;
+    bool useSweepCache = true;
+
+    // second == nullptr: linked, kênh 2 dùng chung snapshot của kênh đầu
+    void publishSnapshots(const ChainSettings& first, const ChainSettings* second);
+    void publishSnapshot(int channel, const ChainSettings& chainSettings, double sampleRate);
+
+    // chỉ gán con trỏ hệ số vào chain (engine của độ chính xác đang dùng), chạy trên audio thread khi có bản mới
+    void applySnapshots();
+    template<typename SampleType>
+    void applySnapshot(const CoefficientSnapshot& snapshot, ChannelList channels, int dynamicChannel);
 
     void updateFilters();
 
+    // param đọc ở đầu block (target) và giá trị đã dùng tới cuối block trước (current)
+    std::array<ChainSettings, 2> currentSettings, targetSettings;
+
+    // block sau nhảy thẳng tới target (đổi slot A/B), không glide từ slot cũ
+    std::atomic<bool> snapToTarget{ false };
+
+    /*
+    seqlock cho các lần ghi nguyên bộ param từ message thread (preset, slot A/B, setStateInformation, match fit):
+    lẻ = đang ghi dở, audio thread giữ target cũ; đọc xong mà số đã đổi thì bỏ kết quả, block sau đọc lại.
+    Audio thread luôn thấy trọn bộ cũ hoặc trọn bộ mới, không bao giờ nửa preset.
+    */
+    std::atomic<juce::uint32> parameterWriteSequence{ 0 };
+    template<typename Function>
+    void writeParametersAsOneUnit(Function&& write);
+
+    // audio thread chỉ thử lock: message thread đang đổi fifo thì block đó không nạp analyzer
+    AnalyzerFifos::Ptr analyzer;
+    juce::SpinLock analyzerLock;
+    std::atomic<int> analyzerBlockSize{ 0 };
+    std::atomic<double> analyzerSampleRate{ 0 };
+    std::atomic<bool> analyzerActive{ false };
+
+    // input của block được chụp lại trước khi xử lý cho tap trước EQ (cấp trong prepareToPlay)
+    juce::AudioBuffer<float> analyzerInput;
+    int analyzerInputSamples = 0;
+
+    template<typename SampleType>
+    void captureAnalyzerInput(const juce::AudioBuffer<SampleType>& buffer);
+    // nạp cả 4 tap trong một lần lấy lock: tap trước / sau EQ không bao giờ lệch block
+    template<typename SampleType>
+    void feedAnalyzer(const juce::AudioBuffer<SampleType>& buffer);
+
+    // đo ngay trên buffer output trong cùng lượt xử lý, không cần plugin meter riêng
+    LoudnessMeter loudnessMeter;
+    std::atomic<float>* meteringEnabled = nullptr;
+
+    template<typename SampleType>
+    void meterOutput(const juce::AudioBuffer<SampleType>& buffer);
+
+    /*
+    auto gain: mức thay đổi ước lượng thẳng từ đáp ứng biên độ của snapshot đang chạy,
+    trung bình |H|^2 trên lưới log (mỗi điểm cùng trọng số = phổ hồng) nhân K-weighting,
+    nên không cần lọc K-weighting thêm trên input. Chỉ tính lại khi snapshot đổi.
+    Peak động được tính theo gain tĩnh.
+    */
+    static constexpr int autoGainPoints = 24;
+    std::array<double, autoGainPoints> autoGainFrequencies{}, autoGainWeights{};
+    std::atomic<float>* autoGainEnabled = nullptr;
+    // version của snapshot đã tính (0: đang tắt / chưa tính)
+    std::array<juce::uint32, 2> autoGainVersions{};
+    std::array<double, 2> autoGains{ 1.0, 1.0 };
+    std::array<std::atomic<float>, 2> autoGainDecibels{};
+
+    void prepareAutoGain(double sampleRate);
+    double computeAutoGain(const CoefficientSnapshot& snapshot) const;
+    void updateAutoGain();
+
+    AnalyzerExport analyzerExport;
+    std::atomic<float>* analyzerExportEnabled = nullptr;
+
+    std::unique_ptr<MatchEq> matchEq;
+
+    // bank preset map từ file, dùng chung giữa các instance; null thì chỉ có 1 program rỗng
+    PresetBank::Ptr presetBank;
+    std::atomic<int> currentProgram{ 0 };
+    // host gọi setCurrentProgram ngoài message thread: index chờ nạp (-1: không có)
+    std::atomic<int> pendingProgram{ -1 };
+
+    // param của preset / slot A/B (getPresetParameters), lấy 1 lần trong constructor
+    juce::Array<juce::AudioProcessorParameter*> presetParameters;
+
+    void applyProgram(int index);
+    void handleAsyncUpdate() override;
+
+    std::array<juce::MemoryBlock, numCompareSlots> compareStates;
+    int activeCompareSlot = 0;
+
+    // khoảng cách giữa hai lần thiết kế lại khi param đang đổi (bội của controlInterval peak động)
+    static constexpr int parameterInterval = 2 * DynamicPeakBand::controlInterval;
+
+    void readParameters();
+    // kênh đầu (tên gốc) và kênh thứ 2 ("B "), dựng trong constructor sau apvts
+    std::array<ChainParameters, 2> chainParameters{ ChainParameters(apvts, getChannelParameterPrefix(0)),
+                                                    ChainParameters(apvts, getChannelParameterPrefix(1)) };
+
+    // idle: input im lặng và đuôi của các bộ lọc đã tắt hẳn -> không chạy DSP cho tới khi có tín hiệu
+    static constexpr float silenceThreshold = 1.0e-6f;  // -120 dBFS, trên vùng denormal
+    bool idle = false;
+    int silentSamples = 0, idleHoldSamples = 4410;
+    // publish + gán hệ số ở vị trí proportion giữa current và target
+    void renderFilters(float proportion);
+
+    StereoMode stereoMode = StereoMode::Linked;
+
+    // phần chung của 2 processBlock
+    template<typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer);
+
+    template<typename SampleType>
+    static bool isBelowSilenceThreshold(const juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    template<typename SampleType>
+    void enterIdle(EqEngine<SampleType>& engine);
+
+    // block là đoạn của buffer bắt đầu từ startSample
+    template<typename SampleType>
+    void processRange(juce::dsp::AudioBlock<SampleType>& block, juce::AudioBuffer<SampleType>& buffer, int startSample);
+
+    template<typename SampleType>
+    void processChains(juce::dsp::AudioBlock<SampleType>& block);
+
+    // bypass hoàn toàn: chạy chain trên bản copy của cả block (bộ đệm dry) để giữ trạng thái ấm
+    template<typename SampleType>
+    void warmUpChains(const juce::AudioBuffer<SampleType>& buffer);
+    // 2 kênh L/R qua 2 chain theo block
+    template<typename SampleType>
+    void processChannels(juce::dsp::AudioBlock<SampleType>& block);
+    // M/S: encode trong vòng lặp của tầng đầu chain mid, decode trong vòng lặp của tầng band (không lượt riêng)
+    template<typename SampleType>
+    void processMidSide(juce::dsp::AudioBlock<SampleType>& block);
+
+    // band Peak động của từng kênh: detector + bảng hệ số, cập nhật mỗi controlInterval sample
+    std::array<DynamicPeakBand, 2> dynamicPeaks;
+    std::array<bool, 2> dynamicPeakActive{}, dynamicPeakUsesSidechain{};
+
+    void updateDynamicPeak(const ChainSettings& chainSettings, int channel);
+    template<typename SampleType>
+    void processDynamicPeak(juce::dsp::AudioBlock<SampleType>& block, juce::AudioBuffer<SampleType>& buffer, int startSample);
+
     juce::dsp::Oscillator<float> osc;
 
     //==============================================================================
@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+
+#include "ParametricBands.h"
+
+namespace
+{
+    // giá trị thật (Hz, dB, chỉ số choice), param không liệt kê giữ mặc định
+    struct FactoryPreset
+    {
+        juce::String name;
+        std::vector<std::pair<juce::String, float>> values;
+    };
+
+    std::vector<FactoryPreset> getFactoryPresets()
+    {
+        auto band = [](int index, const juce::String& name) { return getBandParameterID(index, name); };
+
+        return {
+            { "Init", {} },
+            { "Low Cut 80 Hz", { { "LowCut Freq", 80.f }, { "LowCut Slope", 2.f } } },
+            { "Vocal Presence", {
+                { "LowCut Freq", 100.f }, { "LowCut Slope", 1.f },
+                { "Peak Freq", 3000.f }, { "Peak Gain", 3.f }, { "Peak Quality", 0.8f },
+                { band(0, "Enabled"), 1.f }, { band(0, "Type"), (float)BandType::HighShelf },
+                { band(0, "Freq"), 10000.f }, { band(0, "Gain"), 2.f } } },
+            { "De-Mud", {
+                { "LowCut Freq", 40.f },
+                { "Peak Freq", 250.f }, { "Peak Gain", -3.f }, { "Peak Quality", 1.f } } },
+            { "Kick Tighten", {
+                { "Peak Freq", 300.f }, { "Peak Gain", -4.f }, { "Peak Quality", 1.4f },
+                { band(0, "Enabled"), 1.f }, { band(0, "Freq"), 60.f }, { band(0, "Gain"), 3.f },
+                { "HighCut Freq", 12000.f } } },
+            { "Air", {
+                { band(0, "Enabled"), 1.f }, { band(0, "Type"), (float)BandType::HighShelf },
+                { band(0, "Freq"), 12000.f }, { band(0, "Gain"), 4.f }, { band(0, "Quality"), 0.7f } } },
+            { "Telephone", {
+                { "LowCut Freq", 400.f }, { "LowCut Slope", 3.f },
+                { "HighCut Freq", 3400.f }, { "HighCut Slope", 3.f },
+                { "Peak Freq", 1500.f }, { "Peak Gain", 4.f }, { "Peak Quality", 1.5f } } },
+            { "Side Air (M/S)", {
+                { "Stereo Mode", 2.f },
+                { "B LowCut Freq", 120.f },
+                { "B " + band(0, "Enabled"), 1.f }, { "B " + band(0, "Type"), (float)BandType::HighShelf },
+                { "B " + band(0, "Freq"), 8000.f }, { "B " + band(0, "Gain"), 3.f } } },
+        };
+    }
+
+    bool writeFactoryBank(const juce::File& file, juce::AudioProcessorValueTreeState& apvts,
+        const juce::Array<juce::AudioProcessorParameter*>& parameters)
+    {
+        juce::StringArray names;
+        juce::Array<juce::MemoryBlock> states;
+
+        for (const auto& preset : getFactoryPresets()) {
+            juce::Array<float> values;
+            for (auto* parameter : parameters)
+                values.add(parameter->getDefaultValue());
+
+            for (const auto& [id, value] : preset.values) {
+                auto* parameter = apvts.getParameter(id);
+                auto index = parameters.indexOf(parameter);
+
+                // preset chỉ được chạm vào các param của bank
+                jassert(index >= 0);
+                if (index >= 0)
+                    values.set(index, parameter->convertTo0to1(value));
+            }
+
+            juce::MemoryBlock state;
+            writeBinaryState(parameters, values, state);
+
+            names.add(preset.name);
+            states.add(state);
+        }
+
+        return PresetBank::writeBank(file, names, states);
+    }
+}
+
+PresetBank::Ptr PresetBank::getShared(juce::AudioProcessorValueTreeState& apvts, const juce::Array<juce::AudioProcessorParameter*>& parameters)
+{
+    static juce::CriticalSection lock;
+    static Ptr shared;
+
+    const juce::ScopedLock sl(lock);
+
+    if (shared != nullptr)
+        return shared;
+
+    auto file = getDefaultFile();
+    if (!file.existsAsFile() && !writeFactoryBank(file, apvts, parameters))
+        return nullptr;
+
+    Ptr bank = new PresetBank(file);
+
+    // file hỏng / không map được: instance sau thử lại
+    if (bank->map == nullptr)
+        return nullptr;
+
+    shared = bank;
+    return shared;
+}
+
+juce::File PresetBank::getDefaultFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AudioPluginBeta")
+        .getChildFile("Presets.eqbank");
+}
+
+bool PresetBank::writeBank(const juce::File& file, const juce::StringArray& names, const juce::Array<juce::MemoryBlock>& states)
+{
+    if (names.size() != states.size() || states.isEmpty())
+        return false;
+
+    const auto stateSize = (int)states.getReference(0).getSize();
+    for (const auto& state : states)
+        if ((int)state.getSize() != stateSize)
+            return false;
+
+    if (file.getParentDirectory().createDirectory().failed())
+        return false;
+
+    // ghi ra file tạm rồi thay một lần, instance khác không bao giờ map phải bank ghi dở
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return false;
+
+        out.writeInt((int)magic);
+        out.writeInt((int)version);
+        out.writeInt(states.size());
+        out.writeInt(nameSize + stateSize);
+
+        for (int i = 0; i < states.size(); ++i) {
+            char name[nameSize] = {};
+            names[i].copyToUTF8(name, nameSize);
+
+            out.write(name, nameSize);
+            out.write(states.getReference(i).getData(), (size_t)stateSize);
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+PresetBank::PresetBank(const juce::File& bankFile)
+    : file(bankFile)
+{
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly, false);
+
+    auto size = (juce::int64)mapped->getSize();
+    if (mapped->getData() == nullptr || size < headerSize)
+        return;
+
+    auto* bytes = static_cast<const char*>(mapped->getData());
+    auto storedVersion = juce::ByteOrder::littleEndianInt(bytes + 4);
+    auto storedPresets = (int)juce::ByteOrder::littleEndianInt(bytes + 8);
+    auto storedRecordSize = (int)juce::ByteOrder::littleEndianInt(bytes + 12);
+
+    if (juce::ByteOrder::littleEndianInt(bytes) != magic || storedVersion > version
+        || storedPresets <= 0 || storedRecordSize < nameSize + binaryStateHeaderSize
+        || size < headerSize + (juce::int64)storedPresets * storedRecordSize)
+        return;
+
+    numPresets = storedPresets;
+    recordSize = storedRecordSize;
+    map = std::move(mapped);
+}
+
+const char* PresetBank::getRecord(int index) const noexcept
+{
+    if (map == nullptr || !juce::isPositiveAndBelow(index, numPresets))
+        return nullptr;
+
+    return static_cast<const char*>(map->getData()) + headerSize + (size_t)index * (size_t)recordSize;
+}
+
+juce::String PresetBank::getName(int index) const
+{
+    auto* record = getRecord(index);
+    if (record == nullptr)
+        return {};
+
+    int length = 0;
+    while (length < nameSize && record[length] != 0)
+        ++length;
+
+    return juce::String::fromUTF8(record, length);
+}
+
+bool PresetBank::apply(int index, const juce::Array<juce::AudioProcessorParameter*>& parameters) const
+{
+    auto* record = getRecord(index);
+    return record != nullptr && readBinaryState(parameters, record + nameSize, recordSize - nameSize);
+}
+
+bool PresetBank::rename(int index, const juce::String& newName)
+{
+    if (getRecord(index) == nullptr)
+        return false;
+
+    char name[nameSize] = {};
+    newName.copyToUTF8(name, nameSize);
+
+    // FileOutputStream không cắt file: chỉ ghi đè đúng vùng tên
+    juce::FileOutputStream out(file);
+    return out.openedOk()
+        && out.setPosition(headerSize + (juce::int64)index * recordSize)
+        && out.write(name, nameSize);
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+
+    All presets live in one bank file that is memory-mapped read-only and
+    shared by every instance in the process. Records have a fixed stride
+    (a fixed-size name followed by a PresetState blob), so preset i sits at
+    headerSize + i * recordSize: lookup is O(1) and loading a preset is
+    readBinaryState straight from the mapped pages, with no parse and no
+    allocation. The first instance writes the factory bank if the file
+    does not exist yet.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PresetState.h"
+
+struct PresetBank : juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<PresetBank>;
+
+    // 'EQPB' little-endian
+    static constexpr juce::uint32 magic = 0x42505145;
+    static constexpr juce::uint32 version = 1;
+
+    // magic, version, số preset, độ dài một record
+    static constexpr int headerSize = 4 * (int)sizeof(juce::uint32);
+    // tên UTF-8, đệm 0, luôn có 0 ở cuối
+    static constexpr int nameSize = 32;
+
+    // bank dùng chung cả process, ghi preset factory (chỉ các param trong parameters) nếu chưa có file;
+    // null nếu không map được
+    static Ptr getShared(juce::AudioProcessorValueTreeState& apvts, const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+    static juce::File getDefaultFile();
+
+    // mỗi state là một blob writeBinaryState, cùng số param (record cùng độ dài)
+    static bool writeBank(const juce::File& file, const juce::StringArray& names, const juce::Array<juce::MemoryBlock>& states);
+
+    int getNumPresets() const noexcept { return numPresets; }
+
+    juce::String getName(int index) const;
+
+    // ghi thẳng vào các param trong danh sách, không cấp phát; setValueNotifyingHost nên chỉ gọi trên message thread
+    bool apply(int index, const juce::Array<juce::AudioProcessorParameter*>& parameters) const;
+
+    // ghi đè tên trong file, vùng map (shared) thấy ngay
+    bool rename(int index, const juce::String& newName);
+
+private:
+    explicit PresetBank(const juce::File& bankFile);
+
+    const char* getRecord(int index) const noexcept;
+
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> map;
+    int numPresets = 0, recordSize = 0;
+};
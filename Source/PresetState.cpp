@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    PresetState.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetState.h"
+
+namespace
+{
+    juce::uint32 readUInt32(const char* source)
+    {
+        return juce::ByteOrder::littleEndianInt(source);
+    }
+
+    float readFloat(const char* source)
+    {
+        auto bits = juce::ByteOrder::littleEndianInt(source);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void setIfChanged(juce::AudioProcessorParameter& parameter, float normalisedValue)
+    {
+        normalisedValue = juce::jlimit(0.f, 1.f, normalisedValue);
+        if (parameter.getValue() != normalisedValue)
+            parameter.setValueNotifyingHost(normalisedValue);
+    }
+}
+
+namespace
+{
+    // mỗi entry của version 2: hash ID + giá trị
+    constexpr int binaryStateEntrySize = (int)(sizeof(juce::uint32) + sizeof(float));
+
+    template<typename GetValue>
+    void writeValues(const juce::Array<juce::AudioProcessorParameter*>& parameters, GetValue&& getValue, juce::MemoryBlock& destData)
+    {
+        const auto numParameters = parameters.size();
+        destData.setSize((size_t)(binaryStateHeaderSize + numParameters * binaryStateEntrySize), false);
+
+        juce::MemoryOutputStream mos(destData, false);
+        mos.writeInt((int)binaryStateMagic);
+        mos.writeInt((int)binaryStateVersion);
+        mos.writeInt(numParameters);
+
+        for (int i = 0; i < numParameters; ++i) {
+            mos.writeInt((int)getParameterIDHash(*parameters[i]));
+            mos.writeFloat(getValue(i));
+        }
+    }
+
+    // version 1: mảng float theo vị trí trong layout
+    void readPositional(const juce::Array<juce::AudioProcessorParameter*>& parameters, const char* values, int numStored)
+    {
+        for (auto* parameter : parameters) {
+            auto index = parameter->getParameterIndex();
+
+            if (juce::isPositiveAndBelow(index, numStored))
+                setIfChanged(*parameter, readFloat(values + index * (int)sizeof(float)));
+            else
+                setIfChanged(*parameter, parameter->getDefaultValue());
+        }
+    }
+
+    void readHashed(const juce::Array<juce::AudioProcessorParameter*>& parameters, const char* entries, int numStored)
+    {
+        // entry thường theo đúng thứ tự của danh sách: tìm tiếp từ entry vừa khớp, vòng lại đầu nếu cần
+        int next = 0;
+
+        for (auto* parameter : parameters) {
+            const auto hash = getParameterIDHash(*parameter);
+            auto value = parameter->getDefaultValue();
+
+            for (int n = 0; n < numStored; ++n) {
+                auto entry = (next + n) % numStored;
+                auto* source = entries + entry * binaryStateEntrySize;
+
+                if (readUInt32(source) == hash) {
+                    value = readFloat(source + sizeof(juce::uint32));
+                    next = entry + 1;
+                    break;
+                }
+            }
+
+            setIfChanged(*parameter, value);
+        }
+    }
+}
+
+juce::uint32 getParameterIDHash(const juce::AudioProcessorParameter& parameter)
+{
+    auto* withID = dynamic_cast<const juce::AudioProcessorParameterWithID*>(&parameter);
+    jassert(withID != nullptr);
+
+    juce::uint32 hash = 2166136261u;
+    if (withID != nullptr)
+        for (auto* c = withID->paramID.toRawUTF8(); *c != 0; ++c)
+            hash = (hash ^ (juce::uint8)*c) * 16777619u;
+
+    return hash;
+}
+
+void writeBinaryState(const juce::Array<juce::AudioProcessorParameter*>& parameters, juce::MemoryBlock& destData)
+{
+    writeValues(parameters, [&parameters](int i) { return parameters[i]->getValue(); }, destData);
+}
+
+void writeBinaryState(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+    const juce::Array<float>& normalisedValues, juce::MemoryBlock& destData)
+{
+    jassert(normalisedValues.size() == parameters.size());
+    writeValues(parameters, [&normalisedValues](int i) { return normalisedValues[i]; }, destData);
+}
+
+bool isBinaryState(const void* data, int sizeInBytes)
+{
+    return data != nullptr
+        && sizeInBytes >= binaryStateHeaderSize
+        && readUInt32(static_cast<const char*>(data)) == binaryStateMagic;
+}
+
+bool readBinaryState(const juce::Array<juce::AudioProcessorParameter*>& parameters, const void* data, int sizeInBytes)
+{
+    if (!isBinaryState(data, sizeInBytes))
+        return false;
+
+    auto* bytes = static_cast<const char*>(data);
+    auto version = readUInt32(bytes + 4);
+    auto numStored = (int)readUInt32(bytes + 8);
+    auto entrySize = version >= 2 ? binaryStateEntrySize : (int)sizeof(float);
+
+    // so bằng phép chia: numStored lớn (blob hỏng / cố ý) không làm tràn int
+    if (version == 0 || version > binaryStateVersion || numStored < 0
+        || numStored > (sizeInBytes - binaryStateHeaderSize) / entrySize)
+        return false;
+
+    if (version == 1)
+        readPositional(parameters, bytes + binaryStateHeaderSize, numStored);
+    else
+        readHashed(parameters, bytes + binaryStateHeaderSize, numStored);
+
+    return true;
+}
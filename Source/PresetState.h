@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    PresetState.h
+
+    Compact binary plugin state: a small versioned header followed by one
+    { parameter ID hash, normalised value } pair per stored parameter.
+    Values are matched to parameters by ID hash, not by position, so a
+    reordered, removed or renamed parameter can never receive another
+    parameter's value: stored entries that match nothing are ignored and
+    parameters missing from the blob go back to their default. Loading
+    writes the values straight into the parameters, skipping the ValueTree
+    parse and the replaceState listener storm. Version 1 blobs (a plain
+    positional float array, written while the layout was append-only) and
+    blobs without the header (the old ValueTree format) are still accepted.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// 'EQBS' little-endian
+constexpr juce::uint32 binaryStateMagic = 0x53425145;
+constexpr juce::uint32 binaryStateVersion = 2;
+
+// magic, version, số param
+constexpr int binaryStateHeaderSize = 3 * (int)sizeof(juce::uint32);
+
+// FNV-1a 32-bit của paramID (UTF-8), cố định giữa các bản build / nền tảng
+juce::uint32 getParameterIDHash(const juce::AudioProcessorParameter& parameter);
+
+void writeBinaryState(const juce::Array<juce::AudioProcessorParameter*>& parameters, juce::MemoryBlock& destData);
+
+// cùng định dạng nhưng giá trị chuẩn hoá lấy từ normalisedValues[i] (preset factory) thay vì đọc param
+void writeBinaryState(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+    const juce::Array<float>& normalisedValues, juce::MemoryBlock& destData);
+
+// có header hợp lệ (không phải blob ValueTree cũ)
+bool isBinaryState(const void* data, int sizeInBytes);
+
+/*
+nạp thẳng vào các param trong danh sách, không cấp phát. Param không đổi giá trị thì bỏ qua
+(không báo host), param không có trong blob (preset cũ hơn) về giá trị mặc định.
+trả về false nếu blob hỏng hoặc đến từ version mới hơn.
+*/
+bool readBinaryState(const juce::Array<juce::AudioProcessorParameter*>& parameters, const void* data, int sizeInBytes);
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    Spectrogram.cpp
+
+  ==============================================================================
+*/
+
+#include "Spectrogram.h"
+
+Spectrogram::Spectrogram(int numPoints, int historyLength)
+    // ảnh software: ghi thẳng vào pixel, không phải copy ngược từ texture mỗi khung
+    : image(juce::Image::ARGB, juce::jmax(1, numPoints), juce::jmax(1, historyLength), true, juce::SoftwareImageType())
+{
+}
+
+const std::array<juce::PixelARGB, Spectrogram::lutSize>& Spectrogram::getColourTable()
+{
+    static const auto table = [] {
+        juce::ColourGradient gradient;
+        gradient.addColour(0.0, juce::Colours::transparentBlack);
+        gradient.addColour(0.15, juce::Colour(0xff10104a));
+        gradient.addColour(0.4, juce::Colour(0xff7a1c8c));
+        gradient.addColour(0.65, juce::Colour(0xffe0402a));
+        gradient.addColour(0.85, juce::Colour(0xfff5c030));
+        gradient.addColour(1.0, juce::Colours::white);
+
+        std::array<juce::PixelARGB, lutSize> colours;
+        for (int i = 0; i < lutSize; ++i)
+            colours[(size_t)i] = gradient.getColourAtPosition((double)i / double(lutSize - 1)).getPixelARGB();
+
+        return colours;
+    }();
+
+    return table;
+}
+
+void Spectrogram::pushFrame(const std::vector<float>& magnitudes)
+{
+    const auto width = juce::jmin(image.getWidth(), (int)magnitudes.size());
+    const auto& table = getColourTable();
+
+    // chỉ khoá đúng 1 hàng: O(số điểm lưới), phần lịch sử không bị đụng tới
+    {
+        juce::Image::BitmapData row(image, 0, writeRow, image.getWidth(), 1, juce::Image::BitmapData::writeOnly);
+        auto* pixel = row.getLinePointer(0);
+
+        constexpr auto scale = float(lutSize - 1) / (maxDecibels - minDecibels);
+
+        for (int x = 0; x < width; ++x) {
+            auto db = juce::Decibels::gainToDecibels(magnitudes[(size_t)x], minDecibels);
+            auto index = juce::jlimit(0, lutSize - 1, (int)((db - minDecibels) * scale));
+
+            *reinterpret_cast<juce::PixelARGB*>(pixel) = table[(size_t)index];
+            pixel += row.pixelStride;
+        }
+    }
+
+    newestRow = writeRow;
+    writeRow = (writeRow + image.getHeight() - 1) % image.getHeight();
+}
+
+void Spectrogram::clear()
+{
+    image.clear(image.getBounds());
+    writeRow = newestRow = 0;
+}
+
+void Spectrogram::draw(juce::Graphics& g, juce::Rectangle<int> area) const
+{
+    const auto height = image.getHeight();
+    const auto width = image.getWidth();
+
+    // ring cắt ở newestRow: [newestRow, height) là phần mới ở trên, [0, newestRow) là phần cũ ở dưới
+    const auto newerRows = height - newestRow;
+    const auto newerHeight = area.getHeight() * newerRows / height;
+
+    g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+
+    g.drawImage(image, area.getX(), area.getY(), area.getWidth(), newerHeight,
+        0, newestRow, width, newerRows);
+
+    if (newestRow > 0)
+        g.drawImage(image, area.getX(), area.getY() + newerHeight, area.getWidth(), area.getHeight() - newerHeight,
+            0, 0, width, newestRow);
+}
+
+size_t Spectrogram::getMemoryUsage() const
+{
+    return (size_t)image.getWidth() * (size_t)image.getHeight() * sizeof(juce::PixelARGB);
+}
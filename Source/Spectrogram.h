@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    Spectrogram.h
+
+    Scrolling spectrogram (waterfall) of the analyzer's log-frequency grid.
+    Frames are written into a ring-buffered software image, one line per
+    frame, through a precomputed dB -> pixel colour table, so a new frame
+    costs O(grid points) however much history is kept. Nothing already in
+    the image is touched again: scrolling comes from where the ring is cut
+    when it is blitted (two drawImage calls), not from redrawing history.
+
+    The analyzer's frequency axis is horizontal (same x as the response
+    curve and grid lines), so a frame is one image row and time runs
+    downwards, newest at the top.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct Spectrogram
+{
+    // -90 dB .. 0 dB trải trên bảng màu, dưới sàn trong suốt (thấy lưới phía sau)
+    static constexpr float minDecibels = -90.f;
+    static constexpr float maxDecibels = 0.f;
+
+    // numPoints: số điểm lưới (chiều ngang ảnh), historyLength: số khung giữ lại (chiều dọc)
+    Spectrogram(int numPoints, int historyLength);
+
+    // magnitudes tuyến tính trên lưới, đúng numPoints phần tử
+    void pushFrame(const std::vector<float>& magnitudes);
+
+    void clear();
+
+    // khung mới nhất ở mép trên của area
+    void draw(juce::Graphics& g, juce::Rectangle<int> area) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    static constexpr int lutSize = 256;
+
+    juce::Image image;
+
+    // hàng sẽ nhận khung kế tiếp, đi ngược lên (ring): khung mới nhất luôn ở newestRow
+    int writeRow = 0, newestRow = 0;
+
+    // dB -> màu đã premultiply, tính 1 lần cho mọi instance
+    static const std::array<juce::PixelARGB, lutSize>& getColourTable();
+};
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    StereoAnalysis.cpp
+
+  ==============================================================================
+*/
+
+#include "StereoAnalysis.h"
+
+void StereoAnalysis::prepare(double sampleRate, const std::vector<float>& gridFrequencies)
+{
+    // hằng số thời gian 300 ms, goniometer ~12k điểm / giây (512 điểm ~ 43 ms)
+    smoothing = (float)std::exp(-1.0 / (0.3 * sampleRate));
+    decimation = juce::jmax(1, juce::roundToInt(sampleRate / 12000.0));
+
+    bandOfPoint.resize(gridFrequencies.size());
+    for (size_t i = 0; i < gridFrequencies.size(); ++i) {
+        auto band = (int)std::floor(std::log2(gridFrequencies[i] / getBandCentre(0)) + 0.5f);
+        bandOfPoint[i] = juce::isPositiveAndBelow(band, numBands) ? band : -1;
+    }
+
+    reset();
+}
+
+void StereoAnalysis::reset()
+{
+    sumLR = sumLL = sumRR = 0.f;
+    decimationCounter = 0;
+
+    points.fill({});
+    writeIndex = 0;
+
+    smoothedCross.fill(0.f);
+    smoothedLeft.fill(0.f);
+    smoothedRight.fill(0.f);
+    bandCorrelations.fill(0.f);
+}
+
+void StereoAnalysis::push(const float* left, const float* right, int numSamples)
+{
+    constexpr auto rotation = juce::MathConstants<float>::sqrt2 * 0.5f;
+    const auto a = smoothing, b = 1.f - smoothing;
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto l = left[i], r = right[i];
+
+        sumLR = a * sumLR + b * l * r;
+        sumLL = a * sumLL + b * l * l;
+        sumRR = a * sumRR + b * r * r;
+
+        if (++decimationCounter < decimation)
+            continue;
+
+        decimationCounter = 0;
+
+        // xoay 45 độ: mono thành đường đứng, L / R thành 2 đường chéo
+        points[(size_t)writeIndex] = { (r - l) * rotation, (l + r) * rotation };
+        writeIndex = (writeIndex + 1) % numPoints;
+    }
+}
+
+float StereoAnalysis::getCorrelation() const
+{
+    auto power = std::sqrt(sumLL * sumRR);
+    return power > 1e-10f ? juce::jlimit(-1.f, 1.f, sumLR / power) : 0.f;
+}
+
+void StereoAnalysis::updateBands(const MultiResolutionSpectrum& left, const MultiResolutionSpectrum& right)
+{
+    MultiResolutionSpectrum::getCrossSpectrum(left, right, cross, leftPower, rightPower);
+
+    std::array<float, numBands> bandCross{}, bandLeft{}, bandRight{};
+    for (size_t i = 0; i < bandOfPoint.size() && i < cross.size(); ++i) {
+        auto band = bandOfPoint[i];
+        if (band < 0)
+            continue;
+
+        bandCross[(size_t)band] += cross[i];
+        bandLeft[(size_t)band] += leftPower[i];
+        bandRight[(size_t)band] += rightPower[i];
+    }
+
+    // làm mượt tổng (không phải tỉ số) như đường chênh lệch của pipeline
+    for (size_t band = 0; band < (size_t)numBands; ++band) {
+        smoothedCross[band] += 0.3f * (bandCross[band] - smoothedCross[band]);
+        smoothedLeft[band] += 0.3f * (bandLeft[band] - smoothedLeft[band]);
+        smoothedRight[band] += 0.3f * (bandRight[band] - smoothedRight[band]);
+
+        auto power = std::sqrt(smoothedLeft[band] * smoothedRight[band]);
+        bandCorrelations[band] = power > 1e-12f ? juce::jlimit(-1.f, 1.f, smoothedCross[band] / power) : 0.f;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    StereoAnalysis.h
+
+    Stereo stage of the analyzer pipeline: looks at the post-EQ left and
+    right taps together, in the same drain that feeds the spectra.
+    - running correlation (exponential, ~300 ms, like a correlation meter)
+    - goniometer: a decimated ring of M/S-rotated sample points
+    - per-octave phase correlation, from the complex bins the spectra
+      already computed (no extra FFT)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "MultiResolutionSpectrum.h"
+
+struct StereoAnalysis
+{
+    // dải octave 31.5 Hz .. 16 kHz
+    static constexpr int numBands = 10;
+    static constexpr int numPoints = 512;
+
+    static float getBandCentre(int band) { return 31.25f * float(1 << band); }
+
+    // gridFrequencies: lưới của các MultiResolutionSpectrum sẽ đưa vào updateBands
+    void prepare(double sampleRate, const std::vector<float>& gridFrequencies);
+    void reset();
+
+    // 1 block của 2 tap sau EQ (cùng vị trí thời gian)
+    void push(const float* left, const float* right, int numSamples);
+
+    // tương quan theo dải từ bin phức của lần analyse gần nhất
+    void updateBands(const MultiResolutionSpectrum& left, const MultiResolutionSpectrum& right);
+
+    // -1 (ngược pha) .. +1 (mono), 0 khi im lặng
+    float getCorrelation() const;
+    float getBandCorrelation(int band) const { return bandCorrelations[(size_t)band]; }
+
+    // x = side, y = mid (L lệch trái, R lệch phải), biên độ 1 nằm trên đường tròn đơn vị
+    const std::array<juce::Point<float>, numPoints>& getPoints() const { return points; }
+
+private:
+    // hệ số trung bình mũ theo sample, lấy 1 điểm goniometer mỗi decimation sample
+    float smoothing = 0.f;
+    int decimation = 1, decimationCounter = 0;
+
+    float sumLR = 0.f, sumLL = 0.f, sumRR = 0.f;
+
+    std::array<juce::Point<float>, numPoints> points{};
+    int writeIndex = 0;
+
+    // dải của từng điểm lưới (-1: ngoài mọi dải)
+    std::vector<int> bandOfPoint;
+    std::vector<float> cross, leftPower, rightPower;
+
+    // tổng theo dải làm mượt qua các khung
+    std::array<float, numBands> smoothedCross{}, smoothedLeft{}, smoothedRight{}, bandCorrelations{};
+};
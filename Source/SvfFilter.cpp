@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    SvfFilter.cpp
+
+  ==============================================================================
+*/
+
+#include "SvfFilter.h"
+
+namespace
+{
+    // A = 10^(dB / 40) = sqrt(gainFactor), cùng A với công thức RBJ
+    double shelfAmplitude(float gainFactor)
+    {
+        return std::sqrt(juce::jmax(1.0e-6, (double)gainFactor));
+    }
+
+    SvfSection makeSvfShelf(double sampleRate, float frequency, float Q, float gainFactor, bool high, const PrewarpTable* prewarpTable)
+    {
+        auto A = shelfAmplitude(gainFactor);
+        auto t = getPrewarp(frequency, sampleRate, prewarpTable);
+        auto k = 1.0 / Q;
+
+        SvfSection section;
+        section.k = (float)k;
+
+        if (high) {
+            section.g = (float)(t * std::sqrt(A));
+            section.m0 = (float)(A * A);
+            section.m1 = (float)(k * (1.0 - A) * A);
+            section.m2 = (float)(1.0 - A * A);
+        }
+        else {
+            section.g = (float)(t / std::sqrt(A));
+            section.m0 = 1.f;
+            section.m1 = (float)(k * (A - 1.0));
+            section.m2 = (float)(A * A - 1.0);
+        }
+
+        return section;
+    }
+
+    SvfSection makeSvfResponse(double g, double Q, float m0, float m1OverK, float m2)
+    {
+        SvfSection section;
+        section.g = (float)g;
+        section.k = (float)(1.0 / Q);
+        section.m0 = m0;
+        section.m1 = m1OverK * section.k;
+        section.m2 = m2;
+        return section;
+    }
+}
+
+SvfSection makeSvfPeak(double sampleRate, float frequency, float Q, float gainFactor, const PrewarpTable* prewarpTable)
+{
+    // (s^2 + s A/Q + 1) / (s^2 + s/(A Q) + 1): k = 1/(A Q), m1 = k (A^2 - 1)
+    auto A = shelfAmplitude(gainFactor);
+    auto k = 1.0 / (A * Q);
+
+    SvfSection section;
+    section.g = (float)getPrewarp(juce::jmax(frequency, 2.f), sampleRate, prewarpTable);
+    section.k = (float)k;
+    section.m0 = 1.f;
+    section.m1 = (float)(k * (A * A - 1.0));
+    section.m2 = 0.f;
+    return section;
+}
+
+SvfSection makeSvfBand(const BandSettings& band, double sampleRate, const PrewarpTable* prewarpTable)
+{
+    auto gainFactor = juce::Decibels::decibelsToGain(band.gainInDecibels);
+
+    switch (band.type) {
+    case BandType::LowShelf:
+        return makeSvfShelf(sampleRate, band.freq, band.quality, gainFactor, false, prewarpTable);
+    case BandType::HighShelf:
+        return makeSvfShelf(sampleRate, band.freq, band.quality, gainFactor, true, prewarpTable);
+    case BandType::Notch:
+        return makeSvfResponse(getPrewarp(band.freq, sampleRate, prewarpTable), band.quality, 1.f, -1.f, 0.f);
+    case BandType::BandPass:
+        // đỉnh 0 dB như bản RBJ: k * band
+        return makeSvfResponse(getPrewarp(band.freq, sampleRate, prewarpTable), band.quality, 0.f, 1.f, 0.f);
+    case BandType::Tilt: {
+        // high shelf rồi hạ cả dải xuống 1 / sqrt(G), giống makeBandFilter
+        auto section = makeSvfShelf(sampleRate, band.freq, band.quality, gainFactor, true, prewarpTable);
+        auto compensation = (float)(1.0 / shelfAmplitude(gainFactor));
+        section.m0 *= compensation;
+        section.m1 *= compensation;
+        section.m2 *= compensation;
+        return section;
+    }
+    case BandType::Bell:
+    default:
+        return makeSvfPeak(sampleRate, band.freq, band.quality, gainFactor, prewarpTable);
+    }
+}
+
+void makeSvfHighPassCascade(SvfSection* sections, float frequency, double sampleRate, int order, const PrewarpTable* prewarpTable)
+{
+    // high = x - k band - low
+    auto g = getPrewarp(frequency, sampleRate, prewarpTable);
+    for (int i = 0; i < order / 2; ++i)
+        sections[i] = makeSvfResponse(g, getButterworthSectionQ(i, order), 1.f, -1.f, -1.f);
+}
+
+void makeSvfLowPassCascade(SvfSection* sections, float frequency, double sampleRate, int order, const PrewarpTable* prewarpTable)
+{
+    auto g = getPrewarp(frequency, sampleRate, prewarpTable);
+    for (int i = 0; i < order / 2; ++i)
+        sections[i] = makeSvfResponse(g, getButterworthSectionQ(i, order), 0.f, 0.f, 1.f);
+}
+
+//==============================================================================
+template<typename SampleType>
+void SvfChain<SampleType>::prepare(double sampleRate)
+{
+    rampLength = juce::jmax(16, juce::roundToInt(sampleRate * 0.001));
+    outputGain.prepare(sampleRate);
+    reset();
+}
+
+template<typename SampleType>
+void SvfChain<SampleType>::reset()
+{
+    for (auto& slot : slots) {
+        slot.ic1eq = slot.ic2eq = 0;
+
+        // bỏ ramp dở dang
+        if (slot.rampRemaining > 0) {
+            slot.current = slot.target;
+            slot.rampRemaining = 0;
+            updateGains(slot);
+        }
+    }
+
+    outputGain.reset();
+}
+
+template<typename SampleType>
+void SvfChain<SampleType>::setParameters(const SvfChainParameters& newParameters)
+{
+    numActive = 0;
+
+    for (int i = 0; i < MaxSvfSections; ++i) {
+        auto& slot = slots[i];
+
+        if (newParameters.active[i]) {
+            if (active[i]) {
+                startRamp(slot, newParameters.sections[i]);
+            }
+            else {
+                // tầng vừa bật: không ramp từ giá trị cũ, xoá trạng thái để không click
+                slot.current = slot.target = newParameters.sections[i];
+                slot.rampRemaining = 0;
+                slot.ic1eq = slot.ic2eq = 0;
+                updateGains(slot);
+            }
+
+            activeSlots[numActive++] = i;
+        }
+
+        active[i] = newParameters.active[i];
+    }
+}
+
+template<typename SampleType>
+void SvfChain<SampleType>::setSection(int slot, const SvfSection& section)
+{
+    jassert(juce::isPositiveAndBelow(slot, MaxSvfSections));
+
+    if (active[slot])
+        startRamp(slots[slot], section);
+}
+
+template<typename SampleType>
+void SvfChain<SampleType>::startRamp(Slot& slot, const SvfSection& target)
+{
+    auto& c = slot.current;
+    const auto step = 1.f / (float)rampLength;
+
+    slot.target = target;
+
+    slot.increment.g = (target.g - c.g) * step;
+    slot.increment.k = (target.k - c.k) * step;
+    slot.increment.m0 = (target.m0 - c.m0) * step;
+    slot.increment.m1 = (target.m1 - c.m1) * step;
+    slot.increment.m2 = (target.m2 - c.m2) * step;
+    slot.rampRemaining = rampLength;
+
+    // đã tới đích (param không đổi): khỏi ramp
+    if (target.g == c.g && target.k == c.k && target.m0 == c.m0 && target.m1 == c.m1 && target.m2 == c.m2)
+        slot.rampRemaining = 0;
+}
+
+template struct SvfChain<float>;
+template struct SvfChain<double>;
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    SvfFilter.h
+
+    Topology-preserving state-variable filter (A. Simper, "Linear Trapezoidal
+    Integrated SVF", Cytomic 2013) as an alternative backend for the whole
+    chain. Every biquad type used by the EQ is the same SVF core with a
+    different output mix y = m0 * x + m1 * band + m2 * low, and the state is
+    held as integrator charges rather than past outputs. The parameters
+    (g, k, m0..m2) can therefore be ramped per sample without zipper or
+    blow-up, and low cutoffs stay well conditioned in float.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "FilterDesign.h"
+#include "ParametricBands.h"
+
+// vị trí cố định của từng tầng trong chain SVF: 4 lowcut, peak, 4 highcut, các band
+constexpr int SvfLowCutSlot = 0;
+constexpr int SvfPeakSlot = SvfLowCutSlot + MaxCutSections;
+constexpr int SvfHighCutSlot = SvfPeakSlot + 1;
+constexpr int SvfBandSlot = SvfHighCutSlot + MaxCutSections;
+constexpr int MaxSvfSections = SvfBandSlot + MaxParametricBands;
+
+// g = tan(pi f / fs) (đã chia / nhân sqrt(A) với shelf), k = 1 / Q
+struct SvfSection {
+    float g{ 0.f }, k{ 1.f };
+    float m0{ 1.f }, m1{ 0.f }, m2{ 0.f };
+};
+
+// hệ số của cả chain, thiết kế 1 lần rồi nạp cho mọi kênh (giống ParametricBandsCoefficients)
+struct SvfChainParameters {
+    std::array<SvfSection, MaxSvfSections> sections{};
+    std::array<bool, MaxSvfSections> active{};
+};
+
+// cùng đáp ứng với các bản biquad bilinear (RBJ / Butterworth) tương ứng
+SvfSection makeSvfPeak(double sampleRate, float frequency, float Q, float gainFactor, const PrewarpTable* prewarpTable = nullptr);
+SvfSection makeSvfBand(const BandSettings& band, double sampleRate, const PrewarpTable* prewarpTable = nullptr);
+void makeSvfHighPassCascade(SvfSection* sections, float frequency, double sampleRate, int order, const PrewarpTable* prewarpTable = nullptr);
+void makeSvfLowPassCascade(SvfSection* sections, float frequency, double sampleRate, int order, const PrewarpTable* prewarpTable = nullptr);
+
+// tham số tầng giữ float (SVF không nhạy với làm tròn hệ số), trạng thái + gain theo SampleType
+template<typename SampleType>
+struct SvfChain
+{
+    // thời gian ramp khi hệ số đổi (~1 ms)
+    void prepare(double sampleRate);
+    void reset();
+
+    // tầng vừa bật thì nhận thẳng giá trị mới, tầng đang chạy thì ramp tới đó
+    void setParameters(const SvfChainParameters& newParameters);
+
+    // đổi một tầng đang bật (peak động theo control rate), ramp từng sample
+    void setSection(int slot, const SvfSection& section);
+
+    // gain bù của auto gain, nhân cùng vòng lặp với tầng cuối
+    void setOutputGain(SampleType gain) { outputGain.setTarget(gain); }
+
+    void process(SampleType* samples, int numSamples)
+    {
+        if (outputGain.isUnity()) {
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = processSections(samples[i]);
+            return;
+        }
+
+        auto gain = outputGain.current;
+        const auto target = outputGain.target, coefficient = outputGain.coefficient;
+
+        for (int i = 0; i < numSamples; ++i) {
+            gain += (target - gain) * coefficient;
+            samples[i] = processSections(samples[i]) * gain;
+        }
+
+        outputGain.current = gain;
+        outputGain.settle();
+    }
+
+    // Mid/Side: mọi tầng của 2 chain trong cùng một vòng lặp, encode lúc đọc và decode lúc ghi
+    // (kèm gain bù của từng chain), không có lượt encode / decode riêng qua buffer
+    static void processMidSide(SvfChain& mid, SvfChain& side, SampleType* left, SampleType* right, int numSamples)
+    {
+        if (mid.outputGain.isUnity() && side.outputGain.isUnity()) {
+            for (int i = 0; i < numSamples; ++i) {
+                auto l = left[i], r = right[i];
+                auto m = mid.processSections((SampleType)0.5 * (l + r));
+                auto s = side.processSections((SampleType)0.5 * (l - r));
+                left[i] = m + s;
+                right[i] = m - s;
+            }
+            return;
+        }
+
+        auto midGain = mid.outputGain.current, sideGain = side.outputGain.current;
+        const auto midTarget = mid.outputGain.target, sideTarget = side.outputGain.target;
+        const auto midCoefficient = mid.outputGain.coefficient, sideCoefficient = side.outputGain.coefficient;
+
+        for (int i = 0; i < numSamples; ++i) {
+            midGain += (midTarget - midGain) * midCoefficient;
+            sideGain += (sideTarget - sideGain) * sideCoefficient;
+
+            auto l = left[i], r = right[i];
+            auto m = mid.processSections((SampleType)0.5 * (l + r)) * midGain;
+            auto s = side.processSections((SampleType)0.5 * (l - r)) * sideGain;
+            left[i] = m + s;
+            right[i] = m - s;
+        }
+
+        mid.outputGain.current = midGain;
+        side.outputGain.current = sideGain;
+        mid.outputGain.settle();
+        side.outputGain.settle();
+    }
+
+private:
+    SampleType processSections(SampleType x)
+    {
+        for (int n = 0; n < numActive; ++n) {
+            auto& s = slots[activeSlots[n]];
+
+            if (s.rampRemaining > 0)
+                advanceRamp(s);
+
+            auto v3 = x - s.ic2eq;
+            auto v1 = s.a1 * s.ic1eq + s.a2 * v3;
+            auto v2 = s.ic2eq + s.a2 * s.ic1eq + s.a3 * v3;
+            s.ic1eq = flushDenormal(2 * v1 - s.ic1eq);
+            s.ic2eq = flushDenormal(2 * v2 - s.ic2eq);
+
+            x = (SampleType)s.current.m0 * x + (SampleType)s.current.m1 * v1 + (SampleType)s.current.m2 * v2;
+        }
+
+        return x;
+    }
+
+    struct Slot {
+        SvfSection current, target, increment;
+        int rampRemaining = 0;
+
+        // a1 = 1 / (1 + g (g + k)), a2 = g a1, a3 = g a2
+        SampleType a1 = 1, a2 = 0, a3 = 0;
+
+        // trạng thái: điện tích 2 tích phân
+        SampleType ic1eq = 0, ic2eq = 0;
+    };
+
+    std::array<Slot, MaxSvfSections> slots;
+    std::array<bool, MaxSvfSections> active{};
+
+    std::array<int, MaxSvfSections> activeSlots{};
+    int numActive = 0;
+
+    int rampLength = 48;
+
+    SmoothedOutputGain<SampleType> outputGain;
+
+    void startRamp(Slot& slot, const SvfSection& target);
+
+    // tích phân band hội tụ về 0 cả khi input có DC nên không bù DC được như biquad:
+    // cộng rồi trừ antiDenormal làm tròn mọi giá trị quá nhỏ về đúng 0 (cần FP strict, không fast-math)
+    static SampleType flushDenormal(SampleType value)
+    {
+        value += antiDenormal<SampleType>;
+        value -= antiDenormal<SampleType>;
+        return value;
+    }
+
+    static void updateGains(Slot& slot)
+    {
+        const auto g = (SampleType)slot.current.g;
+        const auto k = (SampleType)slot.current.k;
+        slot.a1 = 1 / (1 + g * (g + k));
+        slot.a2 = g * slot.a1;
+        slot.a3 = g * slot.a2;
+    }
+
+    static void advanceRamp(Slot& slot)
+    {
+        auto& c = slot.current;
+        const auto& d = slot.increment;
+        c.g += d.g;
+        c.k += d.k;
+        c.m0 += d.m0;
+        c.m1 += d.m1;
+        c.m2 += d.m2;
+
+        // sample cuối của ramp: về đúng đích, không để sai số cộng dồn
+        if (--slot.rampRemaining == 0)
+            c = slot.target;
+
+        updateGains(slot);
+    }
+};
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+    AnalyzerExportReader.cpp
+
+    Reference reader for the analyzer export ring (Linux). Maps a segment
+    read-only and prints every frame it sees: sequence, missed frames,
+    loudness, correlation and a few spectrum points. Shows how to follow the
+    seqlock protocol described in Source/AnalyzerExportLayout.h.
+
+    Build (no JUCE needed):
+        c++ -std=c++17 -O2 -I../../Source AnalyzerExportReader.cpp -o AnalyzerExportReader -lrt
+
+    Usage:
+        AnalyzerExportReader                 list segments, follow the first
+        AnalyzerExportReader <name> [count]  follow <name> for count frames (0 = until closed)
+
+  ==============================================================================
+*/
+
+#include "AnalyzerExportLayout.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    using namespace AnalyzerExportLayout;
+
+    // các segment trong /dev/shm có tiền tố của plugin
+    std::vector<std::string> listSegments()
+    {
+        std::vector<std::string> names;
+        const std::string prefix = namePrefix + 1;
+
+        if (auto* directory = opendir("/dev/shm")) {
+            while (auto* entry = readdir(directory))
+                if (std::strncmp(entry->d_name, prefix.c_str(), prefix.size()) == 0)
+                    names.push_back("/" + std::string(entry->d_name));
+
+            closedir(directory);
+        }
+
+        return names;
+    }
+
+    struct Mapping
+    {
+        const char* data = nullptr;
+        std::size_t size = 0;
+
+        ~Mapping()
+        {
+            if (data != nullptr)
+                munmap(const_cast<char*>(data), size);
+        }
+
+        const Header& header() const { return *reinterpret_cast<const Header*>(data); }
+    };
+
+    bool map(const std::string& name, Mapping& mapping)
+    {
+        auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            std::perror("shm_open");
+            return false;
+        }
+
+        struct stat info {};
+        auto ok = fstat(fd, &info) == 0 && (std::size_t)info.st_size >= sizeof(Header);
+
+        void* data = MAP_FAILED;
+        if (ok)
+            data = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        close(fd);
+
+        if (data == MAP_FAILED) {
+            std::fprintf(stderr, "%s: cannot map\n", name.c_str());
+            return false;
+        }
+
+        mapping.data = static_cast<const char*>(data);
+        mapping.size = (std::size_t)info.st_size;
+
+        // publisher đặt active = 1 (release) sau khi dựng xong header: chưa thấy thì không tin trường nào
+        const auto& header = mapping.header();
+        for (int attempt = 0; header.active.load(std::memory_order_acquire) != 1; ++attempt) {
+            if (attempt == 200) {
+                std::fprintf(stderr, "%s: publisher not active\n", name.c_str());
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        if (header.magic != magic || header.version != version) {
+            std::fprintf(stderr, "%s: unknown layout (magic %08x, version %u)\n", name.c_str(), header.magic, header.version);
+            return false;
+        }
+
+        // mọi offset phải nằm trong segment và segment trong vùng map; so bằng phép chia, không tràn
+        const auto gridBytes = (std::uint64_t)header.numPoints * sizeof(float);
+        const auto valid = header.numPoints > 0 && header.numFrames > 0
+            && header.segmentSize <= mapping.size
+            && header.gridOffset >= sizeof(Header) && header.gridOffset <= header.segmentSize
+            && gridBytes <= header.segmentSize - header.gridOffset
+            && header.framesOffset % alignment == 0 && header.frameStride % alignment == 0
+            && header.frameStride >= sizeof(Frame) + 2 * gridBytes
+            && header.framesOffset <= header.segmentSize
+            && header.numFrames <= (header.segmentSize - header.framesOffset) / header.frameStride;
+
+        if (!valid) {
+            std::fprintf(stderr, "%s: inconsistent header\n", name.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    // bản copy của 1 slot, hợp lệ khi sequence không đổi trong lúc copy
+    struct FrameCopy
+    {
+        std::uint64_t timeNs = 0;
+        std::uint32_t flags = 0;
+        float momentary = 0, shortTerm = 0, integrated = 0, truePeak = 0, correlation = 0;
+        std::vector<float> post, pre;
+    };
+
+    bool readFrame(const Mapping& mapping, std::uint64_t sequence, FrameCopy& copy)
+    {
+        const auto& header = mapping.header();
+        const auto index = (sequence - 1) % header.numFrames;
+        const auto* frame = reinterpret_cast<const Frame*>(mapping.data + header.framesOffset + index * header.frameStride);
+
+        if (frame->sequence.load(std::memory_order_acquire) != sequence)
+            return false;
+
+        copy.timeNs = frame->timeNs;
+        copy.flags = frame->flags;
+        copy.momentary = frame->momentary;
+        copy.shortTerm = frame->shortTerm;
+        copy.integrated = frame->integrated;
+        copy.truePeak = frame->truePeak;
+        copy.correlation = frame->correlation;
+
+        const auto* post = getPostSpectrum(frame);
+        const auto* pre = getPreSpectrum(frame, header.numPoints);
+        copy.post.assign(post, post + header.numPoints);
+        copy.pre.assign(pre, pre + header.numPoints);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return frame->sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    // giá trị tại điểm lưới gần frequency nhất
+    float at(const Mapping& mapping, const std::vector<float>& spectrum, float frequency)
+    {
+        const auto& header = mapping.header();
+        const auto* grid = reinterpret_cast<const float*>(mapping.data + header.gridOffset);
+
+        std::uint32_t best = 0;
+        for (std::uint32_t i = 1; i < header.numPoints; ++i)
+            if (std::abs(std::log(grid[i] / frequency)) < std::abs(std::log(grid[best] / frequency)))
+                best = i;
+
+        return spectrum[best];
+    }
+
+    int follow(const std::string& name, long count)
+    {
+        Mapping mapping;
+        if (!map(name, mapping))
+            return 1;
+
+        const auto& header = mapping.header();
+        std::printf("%s: pid %u, %u points, %u frames, %.0f Hz\n",
+            name.c_str(), header.ownerPid, header.numPoints, header.numFrames, header.sampleRate);
+
+        std::uint64_t last = header.lastSequence.load(std::memory_order_acquire);
+        FrameCopy copy;
+
+        for (long printed = 0; count == 0 || printed < count;) {
+            if (header.active.load(std::memory_order_acquire) == 0) {
+                std::printf("publisher closed\n");
+                break;
+            }
+
+            auto sequence = header.lastSequence.load(std::memory_order_acquire);
+            if (sequence == last || !readFrame(mapping, sequence, copy)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+
+            std::printf("#%llu (+%llu missed) t=%.3f s  post 100 Hz %.1f  1 kHz %.1f  10 kHz %.1f dB",
+                (unsigned long long)sequence, (unsigned long long)(last == 0 ? 0 : sequence - last - 1),
+                copy.timeNs * 1e-9,
+                at(mapping, copy.post, 100.f), at(mapping, copy.post, 1000.f), at(mapping, copy.post, 10000.f));
+
+            if (copy.flags & hasPreSpectrum)
+                std::printf("  pre 1 kHz %.1f dB", at(mapping, copy.pre, 1000.f));
+            if (copy.flags & hasLoudness)
+                std::printf("  M %.1f S %.1f I %.1f LUFS TP %.1f dBTP", copy.momentary, copy.shortTerm, copy.integrated, copy.truePeak);
+            if (copy.flags & hasCorrelation)
+                std::printf("  corr %.2f", copy.correlation);
+
+            std::printf("\n");
+            std::fflush(stdout);
+
+            last = sequence;
+            ++printed;
+        }
+
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+        return follow(argv[1], argc > 2 ? std::atol(argv[2]) : 0);
+
+    auto names = listSegments();
+    if (names.empty()) {
+        std::printf("no analyzer export segments (enable \"Analyzer Export\" with the editor open)\n");
+        return 1;
+    }
+
+    for (const auto& name : names)
+        std::printf("%s\n", name.c_str());
+
+    return follow(names.front(), 0);
+}
@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+    Main.cpp (DenormalBenchmark)
+
+    Times the cut stage of the plugin (BiquadFilter, 4 sections = 48 dB/oct
+    high-pass at 20 Hz) on a decaying tail: 0.5 s of noise followed by 30 s
+    of digital silence, in 512-sample blocks at 48 kHz. Three variants:
+
+        antiDenormal   BiquadFilter as used in the plugin (DC offset per section)
+        plain          same TDF-II section without the offset
+        plain + FTZ    plain section under juce::ScopedNoDenormals
+
+    FTZ/DAZ is left off for the first two, like a host thread that does not
+    set it. Per 5 s window of the tail the best of a few runs is printed in
+    ns per sample, with the number of subnormal output samples: the
+    antiDenormal rows should stay flat at the cost of the noise section.
+
+    Build: open DenormalBenchmark.jucer in the Projucer (same global JUCE
+    module path as the plugin), export, build Release and run.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../../../Source/BiquadFilter.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numSections = 4;
+    constexpr double cutFrequency = 20.0;
+
+    constexpr double noiseSeconds = 0.5, tailSeconds = 30.0, windowSeconds = 5.0;
+    constexpr int numRuns = 5;
+
+    // Q của 4 tầng Butterworth bậc 8
+    constexpr double butterworthQ[numSections] = { 0.5098, 0.6013, 0.9000, 2.5629 };
+
+    // high-pass RBJ, chuẩn hoá a0 trong constructor của Coefficients
+    template<typename SampleType>
+    typename juce::dsp::IIR::Coefficients<SampleType>::Ptr makeHighPass(double q)
+    {
+        const auto w = juce::MathConstants<double>::twoPi * cutFrequency / sampleRate;
+        const auto alpha = std::sin(w) / (2.0 * q);
+        const auto c = std::cos(w);
+
+        return new juce::dsp::IIR::Coefficients<SampleType>((SampleType)((1.0 + c) / 2.0), (SampleType)(-(1.0 + c)), (SampleType)((1.0 + c) / 2.0),
+                                                            (SampleType)(1.0 + alpha), (SampleType)(-2.0 * c), (SampleType)(1.0 - alpha));
+    }
+
+    struct Result
+    {
+        double noiseNs = std::numeric_limits<double>::max();
+        std::vector<double> tailNs;
+        juce::int64 subnormals = 0;
+    };
+
+    template<typename SampleType, bool keepStateNormal>
+    Result run(const std::vector<SampleType>& input, bool flushToZero)
+    {
+        const auto noiseSamples = (int)(noiseSeconds * sampleRate);
+        const auto windowSamples = (int)(windowSeconds * sampleRate);
+        const auto numWindows = (int)(tailSeconds / windowSeconds);
+
+        Result result;
+        result.tailNs.assign((size_t)numWindows, std::numeric_limits<double>::max());
+
+        std::vector<SampleType> buffer(input.size());
+
+        for (int runIndex = 0; runIndex < numRuns; ++runIndex) {
+            std::array<BiquadFilter<SampleType, keepStateNormal>, numSections> sections;
+            for (int i = 0; i < numSections; ++i) {
+                sections[(size_t)i].coefficients = makeHighPass<SampleType>(butterworthQ[i]);
+                sections[(size_t)i].reset();
+            }
+
+            std::copy(input.begin(), input.end(), buffer.begin());
+
+            std::unique_ptr<juce::ScopedNoDenormals> noDenormals;
+            if (flushToZero)
+                noDenormals = std::make_unique<juce::ScopedNoDenormals>();
+
+            // đo từng đoạn (noise, rồi các cửa sổ của đuôi), mỗi đoạn gồm nhiều block
+            auto processRange = [&](int start, int length) {
+                const auto begin = std::chrono::steady_clock::now();
+
+                for (int offset = start; offset < start + length; offset += blockSize) {
+                    auto* samples = buffer.data() + offset;
+                    juce::dsp::AudioBlock<SampleType> block(&samples, 1, (size_t)juce::jmin(blockSize, start + length - offset));
+                    juce::dsp::ProcessContextReplacing<SampleType> context(block);
+
+                    for (auto& section : sections)
+                        section.process(context);
+                }
+
+                const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+                return elapsed / length;
+            };
+
+            result.noiseNs = juce::jmin(result.noiseNs, processRange(0, noiseSamples));
+
+            for (int window = 0; window < numWindows; ++window)
+                result.tailNs[(size_t)window] = juce::jmin(result.tailNs[(size_t)window],
+                                                           processRange(noiseSamples + window * windowSamples, windowSamples));
+        }
+
+        for (auto sample : buffer)
+            if (std::fpclassify(sample) == FP_SUBNORMAL)
+                ++result.subnormals;
+
+        return result;
+    }
+
+    void print(const char* name, const Result& result)
+    {
+        std::printf("%-22s %8.2f  ", name, result.noiseNs);
+        for (auto ns : result.tailNs)
+            std::printf("%8.2f", ns);
+        std::printf("  %10lld\n", (long long)result.subnormals);
+    }
+
+    template<typename SampleType>
+    void runAll(const char* typeName)
+    {
+        const auto numSamples = (int)((noiseSeconds + tailSeconds) * sampleRate);
+        const auto noiseSamples = (int)(noiseSeconds * sampleRate);
+
+        // -6 dBFS noise rồi im lặng tuyệt đối
+        std::vector<SampleType> input((size_t)numSamples, (SampleType)0);
+        juce::Random random(0x5eed);
+        for (int i = 0; i < noiseSamples; ++i)
+            input[(size_t)i] = (SampleType)(0.5f * (2.f * random.nextFloat() - 1.f));
+
+        std::printf("%s\n%-22s %8s  ", typeName, "variant", "noise");
+        for (int window = 0; window < (int)(tailSeconds / windowSeconds); ++window)
+            std::printf("  %2d-%2ds", (int)(window * windowSeconds), (int)((window + 1) * windowSeconds));
+        std::printf("  %10s\n", "subnormals");
+
+        print("antiDenormal", run<SampleType, true>(input, false));
+        print("plain", run<SampleType, false>(input, false));
+        print("plain + FTZ", run<SampleType, false>(input, true));
+        std::printf("\n");
+    }
+}
+
+int main()
+{
+    std::printf("ns per sample, %d x biquad high-pass %.0f Hz, %.0f Hz, %d-sample blocks, best of %d\n\n",
+                numSections, cutFrequency, sampleRate, blockSize, numRuns);
+
+    runAll<float>("float");
+    runAll<double>("double");
+    return 0;
+}